@@ -0,0 +1,77 @@
+/* libUIOHook: Cross-platform keyboard and mouse hooking from userland.
+ * Copyright (C) 2006-2023 Alexander Barker.  All Rights Reserved.
+ * https://github.com/kwhat/libuiohook/
+ *
+ * libUIOHook is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libUIOHook is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "alloc_count.h"
+
+// Only allocations made on threads registered with alloc_count_thread().
+static __thread bool is_counted = false;
+static uint64_t allocations = 0;
+
+#ifdef __GLIBC__
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t count, size_t size);
+extern void *__libc_realloc(void *ptr, size_t size);
+
+void *malloc(size_t size) {
+    if (is_counted) {
+        __atomic_add_fetch(&allocations, 1, __ATOMIC_RELAXED);
+    }
+
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t count, size_t size) {
+    if (is_counted) {
+        __atomic_add_fetch(&allocations, 1, __ATOMIC_RELAXED);
+    }
+
+    return __libc_calloc(count, size);
+}
+
+void *realloc(void *ptr, size_t size) {
+    if (is_counted) {
+        __atomic_add_fetch(&allocations, 1, __ATOMIC_RELAXED);
+    }
+
+    return __libc_realloc(ptr, size);
+}
+#endif
+
+void alloc_count_thread() {
+    is_counted = true;
+}
+
+bool alloc_count_available() {
+    #ifdef __GLIBC__
+    return true;
+    #else
+    return false;
+    #endif
+}
+
+uint64_t alloc_count_get() {
+    return __atomic_load_n(&allocations, __ATOMIC_RELAXED);
+}
+
+void alloc_count_reset() {
+    __atomic_store_n(&allocations, 0, __ATOMIC_RELAXED);
+}
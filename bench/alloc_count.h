@@ -0,0 +1,42 @@
+/* libUIOHook: Cross-platform keyboard and mouse hooking from userland.
+ * Copyright (C) 2006-2023 Alexander Barker.  All Rights Reserved.
+ * https://github.com/kwhat/libuiohook/
+ *
+ * libUIOHook is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libUIOHook is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _included_alloc_count
+#define _included_alloc_count
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Count heap allocations made by the calling thread from now on.  Counting
+ * replaces malloc(), calloc() and realloc() and is only available with glibc.
+ */
+extern void alloc_count_thread();
+
+/* Returns true if allocations are being counted.
+ */
+extern bool alloc_count_available();
+
+/* Returns the number of allocations counted since the last reset.
+ */
+extern uint64_t alloc_count_get();
+
+/* Reset the allocation count to zero.
+ */
+extern void alloc_count_reset();
+
+#endif
@@ -0,0 +1,180 @@
+/* libUIOHook: Cross-platform keyboard and mouse hooking from userland.
+ * Copyright (C) 2006-2023 Alexander Barker.  All Rights Reserved.
+ * https://github.com/kwhat/libuiohook/
+ *
+ * libUIOHook is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libUIOHook is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* Feeds fabricated XRecord data through the same decode and dispatch path as
+ * the running hook.  No XRecord context or physical input is needed, but an X
+ * display, Xvfb is fine, must be available for the keyboard and pointer maps.
+ */
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <uiohook.h>
+
+#include <X11/Xlib.h>
+#include <X11/Xproto.h>
+#include <X11/extensions/record.h>
+
+#include "alloc_count.h"
+#include "input_helper.h"
+
+#define BENCH_EVENTS 1000000
+#define BENCH_RING 4096
+
+// Events seen by the dispatcher.
+static volatile uint64_t dispatched = 0;
+
+static void dispatch_proc(uiohook_event * const event) {
+    dispatched++;
+}
+
+static uint64_t now_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t) ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+// Letters and digits on a pc105 keyboard, evdev and xfree86 both use these.
+static const unsigned char keycodes[] = {
+    10, 11, 12, 13, 14, 15, 16, 17, 18, 19,
+    24, 25, 26, 27, 28, 29, 30, 31, 32, 33,
+    38, 39, 40, 41, 42, 43, 44, 45, 46,
+    52, 53, 54, 55, 56, 57, 58
+};
+
+// Fill in a core device event the way the X server records it.
+static void fill_event(xEvent *xev, unsigned int type, unsigned int i) {
+    memset(xev, 0, sizeof(xEvent));
+
+    xev->u.u.type = type;
+    xev->u.u.sequenceNumber = (CARD16) i;
+    xev->u.keyButtonPointer.time = i;
+
+    // Wander around a 1920x1080 screen.
+    xev->u.keyButtonPointer.rootX = (INT16) ((i * 7) % 1920);
+    xev->u.keyButtonPointer.rootY = (INT16) ((i * 3) % 1080);
+    xev->u.keyButtonPointer.eventX = xev->u.keyButtonPointer.rootX;
+    xev->u.keyButtonPointer.eventY = xev->u.keyButtonPointer.rootY;
+    xev->u.keyButtonPointer.sameScreen = xTrue;
+
+    switch (type) {
+        case KeyPress:
+        case KeyRelease:
+            xev->u.u.detail = keycodes[i % sizeof(keycodes)];
+            // Shift every fourth key.
+            xev->u.keyButtonPointer.state = (i % 4 == 0) ? ShiftMask : 0;
+            break;
+
+        case ButtonPress:
+        case ButtonRelease:
+            xev->u.u.detail = Button1;
+            break;
+
+        default:
+            break;
+    }
+}
+
+typedef struct _bench_case {
+    const char *name;
+    unsigned int types[2];
+    unsigned int count;
+} bench_case;
+
+static const bench_case cases[] = {
+    { "KeyPress",           { KeyPress, 0 },                  1 },
+    { "KeyRelease",         { KeyRelease, 0 },                1 },
+    { "ButtonPress/Release", { ButtonPress, ButtonRelease },  2 },
+    { "MotionNotify",       { MotionNotify, 0 },              1 }
+};
+
+static void run(const bench_case *bench, unsigned int iterations) {
+    // Build the input up front so only the decode and dispatch are timed.
+    static xEvent events[BENCH_RING];
+    for (unsigned int i = 0; i < BENCH_RING; i++) {
+        fill_event(&events[i], bench->types[i % bench->count], i);
+    }
+
+    XRecordInterceptData data;
+    memset(&data, 0, sizeof(data));
+    data.category = XRecordFromServer;
+    data.data_len = sizeof(xEvent) / 4;
+
+    // Warm up.
+    for (unsigned int i = 0; i < BENCH_RING; i++) {
+        data.data = (unsigned char *) &events[i];
+        data.server_time = i;
+        process_intercept_data(&data);
+    }
+
+    dispatched = 0;
+    alloc_count_reset();
+
+    uint64_t start = now_ns();
+    for (unsigned int i = 0; i < iterations; i++) {
+        data.data = (unsigned char *) &events[i % BENCH_RING];
+        data.server_time = i;
+        process_intercept_data(&data);
+    }
+    uint64_t elapsed = now_ns() - start;
+
+    uint64_t allocations = alloc_count_get();
+
+    fprintf(stdout, "%-20s %9.1f ns/event %12.0f events/sec ",
+            bench->name, (double) elapsed / iterations, iterations / (elapsed / 1e9));
+    if (alloc_count_available()) {
+        fprintf(stdout, "%7.3f allocs/event", (double) allocations / iterations);
+    } else {
+        fprintf(stdout, "    n/a allocs/event");
+    }
+    fprintf(stdout, " (%" PRIu64 " dispatched)\n", dispatched);
+}
+
+int main(int argc, char *argv[]) {
+    unsigned int iterations = BENCH_EVENTS;
+    if (argc > 1) {
+        iterations = (unsigned int) strtoul(argv[1], NULL, 10);
+    }
+
+    hook_set_dispatch_proc(&dispatch_proc);
+
+    int status = create_synthetic_hook();
+    if (status != UIOHOOK_SUCCESS) {
+        fprintf(stderr, "Failed to set up the synthetic hook! (%#X)\n", status);
+        return EXIT_FAILURE;
+    }
+
+    unsigned long queries = get_indicator_state_queries();
+    alloc_count_thread();
+
+    fprintf(stdout, "hook_event_proc cost for %u events per type:\n", iterations);
+    for (unsigned int i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        run(&cases[i], iterations);
+    }
+
+    fprintf(stdout, "Indicator queries during the run: %lu\n", get_indicator_state_queries() - queries);
+
+    destroy_synthetic_hook();
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,151 @@
+/* libUIOHook: Cross-platform keyboard and mouse hooking from userland.
+ * Copyright (C) 2006-2023 Alexander Barker.  All Rights Reserved.
+ * https://github.com/kwhat/libuiohook/
+ *
+ * libUIOHook is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libUIOHook is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <uiohook.h>
+
+#define BENCH_EVENTS 10000000
+
+// Bytes produced, keeps the loops from being optimized away.
+static volatile uint64_t bytes;
+
+// A mix of the events a recorder sees, mostly motion.
+static uiohook_event events[8];
+
+static uint64_t now_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t) ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static void init_events() {
+    for (unsigned int i = 0; i < 5; i++) {
+        events[i].type = EVENT_MOUSE_MOVED;
+        events[i].time = 1700000000000ULL + i;
+        events[i].data.mouse.x = (int16_t) (100 + i * 37);
+        events[i].data.mouse.y = (int16_t) (900 - i * 51);
+    }
+
+    events[5].type = EVENT_KEY_PRESSED;
+    events[5].time = 1700000000005ULL;
+    events[5].mask = MASK_SHIFT_L;
+    events[5].data.keyboard.keycode = VC_A;
+    events[5].data.keyboard.rawcode = 0x41;
+
+    events[6].type = EVENT_MOUSE_WHEEL;
+    events[6].time = 1700000000006ULL;
+    events[6].data.wheel.x = 640;
+    events[6].data.wheel.y = 480;
+    events[6].data.wheel.type = WHEEL_UNIT_SCROLL;
+    events[6].data.wheel.amount = 3;
+    events[6].data.wheel.rotation = -1;
+    events[6].data.wheel.direction = WHEEL_VERTICAL_DIRECTION;
+
+    events[7].type = EVENT_MOUSE_PRESSED;
+    events[7].time = 1700000000007ULL;
+    events[7].data.mouse.button = MOUSE_BUTTON1;
+    events[7].data.mouse.clicks = 1;
+    events[7].data.mouse.x = 640;
+    events[7].data.mouse.y = 480;
+}
+
+// The formatting ultracap_hook does with snprintf(), without the wall clock.
+static size_t format_snprintf(const uiohook_event * const event, char *buffer, size_t size) {
+    size_t length = snprintf(buffer, size, "{id:%i,when:%" PRIu64 ",mask:0x%X",
+            event->type, event->time, event->mask);
+
+    switch (event->type) {
+        case EVENT_KEY_PRESSED:
+            length += snprintf(buffer + length, size - length, ",keycode:%u,rawcode:0x%X,event:'KEY_PRESSED'",
+                    event->data.keyboard.keycode, event->data.keyboard.rawcode);
+            break;
+
+        case EVENT_MOUSE_PRESSED:
+            length += snprintf(buffer + length, size - length, ",x:%i,y:%i,button:%i,clicks:%i,event:'MOUSE_PRESSED'",
+                    event->data.mouse.x, event->data.mouse.y,
+                    event->data.mouse.button, event->data.mouse.clicks);
+            break;
+
+        case EVENT_MOUSE_MOVED:
+            length += snprintf(buffer + length, size - length, ",x:%i,y:%i,button:%i,clicks:%i,event:'MOUSE_MOVED'",
+                    event->data.mouse.x, event->data.mouse.y,
+                    event->data.mouse.button, event->data.mouse.clicks);
+            break;
+
+        case EVENT_MOUSE_WHEEL:
+            length += snprintf(buffer + length, size - length, ",type:%i,amount:%i,rotation:%i,event:'MOUSE_WHEEL'",
+                    event->data.wheel.type, event->data.wheel.amount,
+                    event->data.wheel.rotation);
+            break;
+
+        default:
+            break;
+    }
+
+    return length + snprintf(buffer + length, size - length, "}\n");
+}
+
+static void bench_snprintf(unsigned int iterations) {
+    char buffer[UIOHOOK_JSON_MAX_SIZE];
+
+    for (unsigned int i = 0; i < iterations; i++) {
+        bytes += format_snprintf(&events[i & 7], buffer, sizeof(buffer));
+    }
+}
+
+static void bench_json(unsigned int iterations) {
+    char buffer[UIOHOOK_JSON_MAX_SIZE];
+
+    for (unsigned int i = 0; i < iterations; i++) {
+        bytes += hook_event_to_json(&events[i & 7], buffer, sizeof(buffer));
+    }
+}
+
+static void run(const char *name, void (*bench)(unsigned int), unsigned int iterations) {
+    // Warm up.
+    bench(iterations / 10);
+
+    bytes = 0;
+    uint64_t start = now_ns();
+    bench(iterations);
+    uint64_t elapsed = now_ns() - start;
+
+    fprintf(stdout, "%-24s %8.2f ns/event %8.1f bytes/event\n", name,
+            (double) elapsed / iterations, (double) bytes / iterations);
+}
+
+int main(int argc, char *argv[]) {
+    unsigned int iterations = BENCH_EVENTS;
+    if (argc > 1) {
+        iterations = (unsigned int) strtoul(argv[1], NULL, 10);
+    }
+
+    init_events();
+
+    fprintf(stdout, "Event formatting cost for %u events:\n", iterations);
+    run("snprintf (before)", &bench_snprintf, iterations);
+    run("hook_event_to_json", &bench_json, iterations);
+
+    return EXIT_SUCCESS;
+}
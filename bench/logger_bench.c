@@ -0,0 +1,108 @@
+/* libUIOHook: Cross-platform keyboard and mouse hooking from userland.
+ * Copyright (C) 2006-2023 Alexander Barker.  All Rights Reserved.
+ * https://github.com/kwhat/libuiohook/
+ *
+ * libUIOHook is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libUIOHook is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <uiohook.h>
+
+#include "logger.h"
+
+#define BENCH_EVENTS 10000000
+
+// Number of events processed, keeps the loops from being optimized away.
+static volatile uint64_t events;
+
+// Discard everything, like an application that does not want debug output.
+static bool discard_logger(unsigned int level, const char *format, ...) {
+    return false;
+}
+
+static uint64_t now_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t) ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+// Two unconditional indirect calls per event, the previous logger() behavior.
+static void bench_indirect(unsigned int iterations) {
+    volatile logger_t proc = &discard_logger;
+
+    for (unsigned int i = 0; i < iterations; i++) {
+        proc(LOG_LEVEL_DEBUG, "%s [%u]: Key %#X pressed. (%#X)\n",
+                __FUNCTION__, __LINE__, i, i & 0xFF);
+        proc(LOG_LEVEL_DEBUG, "%s [%u]: Dispatching event type %u.\n",
+                __FUNCTION__, __LINE__, i & 0x0F);
+        events++;
+    }
+}
+
+// Debug messages compiled in, but rejected by the runtime level.
+static void bench_runtime_level(unsigned int iterations) {
+    for (unsigned int i = 0; i < iterations; i++) {
+        logger(LOG_LEVEL_DEBUG, "%s [%u]: Key %#X pressed. (%#X)\n",
+                __FUNCTION__, __LINE__, i, i & 0xFF);
+        logger(LOG_LEVEL_DEBUG, "%s [%u]: Dispatching event type %u.\n",
+                __FUNCTION__, __LINE__, i & 0x0F);
+        events++;
+    }
+}
+
+// Debug messages removed with UIOHOOK_LOG_MIN_LEVEL.
+#undef UIOHOOK_LOG_MIN_LEVEL
+#define UIOHOOK_LOG_MIN_LEVEL LOG_LEVEL_INFO
+static void bench_compiled_out(unsigned int iterations) {
+    for (unsigned int i = 0; i < iterations; i++) {
+        logger(LOG_LEVEL_DEBUG, "%s [%u]: Key %#X pressed. (%#X)\n",
+                __FUNCTION__, __LINE__, i, i & 0xFF);
+        logger(LOG_LEVEL_DEBUG, "%s [%u]: Dispatching event type %u.\n",
+                __FUNCTION__, __LINE__, i & 0x0F);
+        events++;
+    }
+}
+
+static void run(const char *name, void (*bench)(unsigned int), unsigned int iterations) {
+    // Warm up.
+    bench(iterations / 10);
+
+    uint64_t start = now_ns();
+    bench(iterations);
+    uint64_t elapsed = now_ns() - start;
+
+    fprintf(stdout, "%-24s %8.2f ns/event\n", name, (double) elapsed / iterations);
+}
+
+int main(int argc, char *argv[]) {
+    unsigned int iterations = BENCH_EVENTS;
+    if (argc > 1) {
+        iterations = (unsigned int) strtoul(argv[1], NULL, 10);
+    }
+
+    hook_set_logger_proc(&discard_logger);
+    hook_set_logger_level(LOG_LEVEL_INFO);
+
+    fprintf(stdout, "Logger cost for %u events, two debug messages each:\n", iterations);
+    run("indirect call (before)", &bench_indirect, iterations);
+    run("runtime level", &bench_runtime_level, iterations);
+    run("compiled out", &bench_compiled_out, iterations);
+
+    return EXIT_SUCCESS;
+}
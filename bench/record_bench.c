@@ -0,0 +1,161 @@
+/* libUIOHook: Cross-platform keyboard and mouse hooking from userland.
+ * Copyright (C) 2006-2023 Alexander Barker.  All Rights Reserved.
+ * https://github.com/kwhat/libuiohook/
+ *
+ * libUIOHook is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libUIOHook is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* Measures capture throughput and heap allocations per event of the X11
+ * backend the library was built with.  Build once with USE_XCB_RECORD=OFF and
+ * once with USE_XCB_RECORD=ON and compare the output.  Requires a running X
+ * server with the XTest and RECORD extensions, Xvfb works fine.
+ */
+
+#include <inttypes.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <uiohook.h>
+
+#include <X11/Xlib.h>
+#include <X11/extensions/XTest.h>
+
+#include "alloc_count.h"
+
+#define BENCH_EVENTS 200000
+#define BENCH_TIMEOUT_NS 30000000000ULL
+
+static volatile bool is_enabled = false;
+static volatile uint64_t received = 0;
+static volatile uint64_t last_received_ns = 0;
+
+static uint64_t now_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t) ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static void dispatch_proc(uiohook_event * const event) {
+    switch (event->type) {
+        case EVENT_HOOK_ENABLED:
+            __atomic_store_n(&is_enabled, true, __ATOMIC_RELEASE);
+            break;
+
+        case EVENT_MOUSE_MOVED:
+        case EVENT_MOUSE_DRAGGED:
+            __atomic_add_fetch(&received, 1, __ATOMIC_RELAXED);
+            __atomic_store_n(&last_received_ns, now_ns(), __ATOMIC_RELAXED);
+            break;
+
+        default:
+            break;
+    }
+}
+
+static void *hook_thread_proc(void *arg) {
+    alloc_count_thread();
+
+    int *status = (int *) arg;
+    *status = hook_run();
+
+    return NULL;
+}
+
+int main(int argc, char *argv[]) {
+    unsigned int count = BENCH_EVENTS;
+    if (argc > 1) {
+        count = (unsigned int) strtoul(argv[1], NULL, 10);
+    }
+
+    Display *display = XOpenDisplay(NULL);
+    if (display == NULL) {
+        fprintf(stderr, "Failed to open the X display!\n");
+        return EXIT_FAILURE;
+    }
+
+    int event_base, error_base, major, minor;
+    if (!XTestQueryExtension(display, &event_base, &error_base, &major, &minor)) {
+        fprintf(stderr, "The XTest extension is not available!\n");
+        XCloseDisplay(display);
+        return EXIT_FAILURE;
+    }
+
+    hook_set_dispatch_proc(&dispatch_proc);
+
+    int status = UIOHOOK_FAILURE;
+    pthread_t hook_thread;
+    if (pthread_create(&hook_thread, NULL, hook_thread_proc, &status) != 0) {
+        fprintf(stderr, "Failed to create the hook thread!\n");
+        XCloseDisplay(display);
+        return EXIT_FAILURE;
+    }
+
+    uint64_t deadline = now_ns() + BENCH_TIMEOUT_NS;
+    while (!__atomic_load_n(&is_enabled, __ATOMIC_ACQUIRE) && now_ns() < deadline) {
+        struct timespec delay = { 0, 1000000 };
+        nanosleep(&delay, NULL);
+    }
+
+    if (!__atomic_load_n(&is_enabled, __ATOMIC_ACQUIRE)) {
+        fprintf(stderr, "The hook did not start!\n");
+        XCloseDisplay(display);
+        return EXIT_FAILURE;
+    }
+
+    alloc_count_reset();
+    __atomic_store_n(&received, 0, __ATOMIC_RELAXED);
+
+    // Alternate between two points so that every request produces a motion.
+    uint64_t start = now_ns();
+    for (unsigned int i = 0; i < count; i++) {
+        XTestFakeMotionEvent(display, -1, (i & 1) ? 100 : 101, 100, CurrentTime);
+        if ((i & 0x3FF) == 0) {
+            XFlush(display);
+        }
+    }
+    XSync(display, False);
+
+    deadline = now_ns() + BENCH_TIMEOUT_NS;
+    while (__atomic_load_n(&received, __ATOMIC_RELAXED) < count && now_ns() < deadline) {
+        struct timespec delay = { 0, 1000000 };
+        nanosleep(&delay, NULL);
+    }
+
+    uint64_t events = __atomic_load_n(&received, __ATOMIC_RELAXED);
+    uint64_t heap_calls = alloc_count_get();
+    uint64_t elapsed = __atomic_load_n(&last_received_ns, __ATOMIC_RELAXED) - start;
+
+    hook_stop();
+    pthread_join(hook_thread, NULL);
+    XCloseDisplay(display);
+
+    if (events == 0) {
+        fprintf(stderr, "No events were received! (%#X)\n", status);
+        return EXIT_FAILURE;
+    }
+
+    fprintf(stdout, "Events:             %" PRIu64 " of %u\n", events, count);
+    fprintf(stdout, "Events/sec:         %.0f\n", events / (elapsed / 1e9));
+    if (alloc_count_available()) {
+        fprintf(stdout, "Allocations/event:  %.3f\n", (double) heap_calls / events);
+    } else {
+        fprintf(stdout, "Allocations/event:  not measured\n");
+    }
+
+    return events == count ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,789 @@
+/* libUIOHook: Cross-platform keyboard and mouse hooking from userland.
+ * Copyright (C) 2006-2023 Alexander Barker.  All Rights Reserved.
+ * https://github.com/kwhat/libuiohook/
+ *
+ * libUIOHook is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libUIOHook is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* End to end benchmark of the X11 path: hook_post_event() through XTest, the X
+ * server, XRecord and input_hook.c back to the dispatcher.  By default a
+ * private Xvfb is started and the benchmark re-executes itself with DISPLAY
+ * pointing at it.  Pass --no-xvfb to use the current DISPLAY instead.
+ *
+ * Startup is measured by launching the benchmark again for each sample, from
+ * fork() to main(), to the hook start event and to the first key event.  With
+ * the keymap cache, create_xkb_state() is also timed with an empty cache and
+ * with one holding the current keymap.
+ */
+
+#include <errno.h>
+#include <getopt.h>
+#include <inttypes.h>
+#include <poll.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <uiohook.h>
+#include <unistd.h>
+
+#ifdef USE_XKB_KEYMAP_CACHE
+#include <dirent.h>
+#include <limits.h>
+
+#include "input_helper.h"
+#endif
+
+#define BENCH_EVENTS        10000
+#define BENCH_RATE          1000
+#define BENCH_DRAIN_NS      2000000000ULL
+#define BENCH_START_NS      10000000000ULL
+#define POST_BATCH_SIZE     256
+
+#define STARTUP_RUNS        20
+#define KEYMAP_RUNS         20
+
+#define CHILD_ENV           "UIOHOOK_BENCH_CHILD"
+#define XVFB_PID_ENV        "UIOHOOK_BENCH_XVFB_PID"
+#define STARTUP_FD_ENV      "UIOHOOK_BENCH_STARTUP_FD"
+
+typedef struct _bench_kind {
+    const char *name;
+    event_type match;
+} bench_kind;
+
+static const bench_kind kinds[] = {
+    { "key",    EVENT_KEY_PRESSED },
+    { "button", EVENT_MOUSE_PRESSED },
+    { "motion", EVENT_MOUSE_MOVED },
+    { "wheel",  EVENT_MOUSE_WHEEL }
+};
+
+// Rates tried when looking for the maximum sustained throughput, 0 is unthrottled.
+static const unsigned int ramp_rates[] = { 1000, 2000, 5000, 10000, 20000, 50000, 100000, 0 };
+
+// State shared with the dispatcher.
+static volatile bool is_enabled = false;
+static volatile uint64_t enabled_ns = 0;
+static volatile event_type current_match = 0;
+static volatile uint64_t received = 0;
+static uint64_t *dispatch_ns = NULL;
+static uint64_t capacity = 0;
+
+static uint64_t now_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t) ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static uint64_t cpu_ns(clockid_t clock) {
+    struct timespec ts;
+    if (clock_gettime(clock, &ts) != 0) {
+        return 0;
+    }
+
+    return (uint64_t) ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+// CPU time used by another process, 0 if unknown.
+static uint64_t process_cpu_ns(pid_t pid) {
+    if (pid <= 0) {
+        return 0;
+    }
+
+    char path[64];
+    snprintf(path, sizeof(path), "/proc/%d/stat", (int) pid);
+
+    FILE *file = fopen(path, "r");
+    if (file == NULL) {
+        return 0;
+    }
+
+    // Fields 14 and 15 are utime and stime, skip past the command name first.
+    char buffer[1024];
+    size_t length = fread(buffer, 1, sizeof(buffer) - 1, file);
+    fclose(file);
+    buffer[length] = '\0';
+
+    char *fields = strrchr(buffer, ')');
+    unsigned long utime = 0, stime = 0;
+    if (fields == NULL || sscanf(fields + 2, "%*c %*d %*d %*d %*d %*d %*u %*u %*u %*u %*u %lu %lu", &utime, &stime) != 2) {
+        return 0;
+    }
+
+    return (uint64_t) (utime + stime) * (1000000000 / sysconf(_SC_CLK_TCK));
+}
+
+static void dispatch_proc(uiohook_event * const event) {
+    if (event->type == EVENT_HOOK_ENABLED) {
+        __atomic_store_n(&enabled_ns, now_ns(), __ATOMIC_RELAXED);
+        __atomic_store_n(&is_enabled, true, __ATOMIC_RELEASE);
+    } else if (event->type == __atomic_load_n(&current_match, __ATOMIC_RELAXED)) {
+        uint64_t index = __atomic_load_n(&received, __ATOMIC_RELAXED);
+        if (index < capacity) {
+            dispatch_ns[index] = now_ns();
+        }
+        __atomic_store_n(&received, index + 1, __ATOMIC_RELEASE);
+    }
+}
+
+static void *hook_thread_proc(void *arg) {
+    int *status = (int *) arg;
+    *status = hook_run();
+
+    return NULL;
+}
+
+// Run the hook on a new thread and wait for it to start.
+static bool start_hook(pthread_t *hook_thread, int *status) {
+    hook_set_dispatch_proc(&dispatch_proc);
+
+    if (pthread_create(hook_thread, NULL, hook_thread_proc, status) != 0) {
+        fprintf(stderr, "Failed to create the hook thread!\n");
+        return false;
+    }
+
+    uint64_t deadline = now_ns() + BENCH_START_NS;
+    while (!__atomic_load_n(&is_enabled, __ATOMIC_ACQUIRE) && now_ns() < deadline) {
+        struct timespec delay = { 0, 1000000 };
+        nanosleep(&delay, NULL);
+    }
+
+    if (!__atomic_load_n(&is_enabled, __ATOMIC_ACQUIRE)) {
+        fprintf(stderr, "The hook did not start! (%#X)\n", *status);
+        return false;
+    }
+
+    return true;
+}
+
+// Inject one measured event, and whatever is needed to return to a neutral state.
+static void post(const bench_kind *kind, unsigned int i) {
+    uiohook_event event;
+    memset(&event, 0, sizeof(event));
+
+    switch (kind->match) {
+        case EVENT_KEY_PRESSED:
+            event.data.keyboard.keycode = VC_A;
+            event.type = EVENT_KEY_PRESSED;
+            hook_post_event(&event);
+            event.type = EVENT_KEY_RELEASED;
+            hook_post_event(&event);
+            break;
+
+        case EVENT_MOUSE_PRESSED:
+            event.data.mouse.button = MOUSE_BUTTON1;
+            event.data.mouse.x = 200;
+            event.data.mouse.y = 200;
+            event.type = EVENT_MOUSE_PRESSED;
+            hook_post_event(&event);
+            event.type = EVENT_MOUSE_RELEASED;
+            hook_post_event(&event);
+            break;
+
+        case EVENT_MOUSE_MOVED:
+            // Alternate between two points so every post is a real motion.
+            event.data.mouse.x = (i & 1) ? 300 : 301;
+            event.data.mouse.y = 300;
+            event.type = EVENT_MOUSE_MOVED;
+            hook_post_event(&event);
+            break;
+
+        case EVENT_MOUSE_WHEEL:
+            event.data.wheel.rotation = (i & 1) ? -1 : 1;
+            event.data.wheel.x = 200;
+            event.data.wheel.y = 200;
+            event.type = EVENT_MOUSE_WHEEL;
+            hook_post_event(&event);
+            break;
+
+        default:
+            break;
+    }
+}
+
+static int compare_uint64(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *) a, y = *(const uint64_t *) b;
+
+    return (x > y) - (x < y);
+}
+
+static uint64_t percentile(const uint64_t *sorted, uint64_t count, double p) {
+    uint64_t index = (uint64_t) (p * (count - 1) + 0.5);
+
+    return sorted[index];
+}
+
+typedef struct _bench_result {
+    uint64_t sent;
+    uint64_t received;
+    double achieved_rate;
+    uint64_t p50, p99, p999, max;
+    double hook_cpu, process_cpu, server_cpu;
+} bench_result;
+
+static void run(const bench_kind *kind, unsigned int count, unsigned int rate,
+        pthread_t hook_thread, pid_t server, bench_result *result) {
+    uint64_t *inject_ns = malloc(sizeof(uint64_t) * count);
+    dispatch_ns = malloc(sizeof(uint64_t) * count);
+    if (inject_ns == NULL || dispatch_ns == NULL) {
+        fprintf(stderr, "Failed to allocate memory for %u timestamps!\n", count);
+        exit(EXIT_FAILURE);
+    }
+
+    clockid_t hook_clock;
+    if (pthread_getcpuclockid(hook_thread, &hook_clock) != 0) {
+        hook_clock = CLOCK_PROCESS_CPUTIME_ID;
+    }
+
+    capacity = count;
+    __atomic_store_n(&received, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&current_match, kind->match, __ATOMIC_RELEASE);
+
+    uint64_t hook_cpu = cpu_ns(hook_clock);
+    uint64_t process_cpu = cpu_ns(CLOCK_PROCESS_CPUTIME_ID);
+    uint64_t server_cpu = process_cpu_ns(server);
+
+    uint64_t start = now_ns();
+    for (unsigned int i = 0; i < count; i++) {
+        if (rate > 0) {
+            uint64_t target = start + (uint64_t) i * 1000000000 / rate;
+            struct timespec ts = { (time_t) (target / 1000000000), (long) (target % 1000000000) };
+            while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR);
+        }
+
+        inject_ns[i] = now_ns();
+        post(kind, i);
+    }
+    uint64_t end = now_ns();
+
+    // Wait for the stragglers.
+    while (__atomic_load_n(&received, __ATOMIC_ACQUIRE) < count && now_ns() - end < BENCH_DRAIN_NS) {
+        struct timespec delay = { 0, 1000000 };
+        nanosleep(&delay, NULL);
+    }
+
+    __atomic_store_n(&current_match, 0, __ATOMIC_RELEASE);
+
+    result->sent = count;
+    result->received = __atomic_load_n(&received, __ATOMIC_ACQUIRE);
+    result->achieved_rate = count / ((end - start) / 1e9);
+
+    uint64_t events = result->received > 0 ? result->received : 1;
+    result->hook_cpu = (double) (cpu_ns(hook_clock) - hook_cpu) / events;
+    result->process_cpu = (double) (cpu_ns(CLOCK_PROCESS_CPUTIME_ID) - process_cpu) / events;
+    result->server_cpu = server > 0 ? (double) (process_cpu_ns(server) - server_cpu) / events : 0;
+
+    // Latencies only line up when nothing was lost.
+    result->p50 = result->p99 = result->p999 = result->max = 0;
+    if (result->received == count) {
+        for (unsigned int i = 0; i < count; i++) {
+            inject_ns[i] = dispatch_ns[i] - inject_ns[i];
+        }
+        qsort(inject_ns, count, sizeof(uint64_t), compare_uint64);
+
+        result->p50 = percentile(inject_ns, count, 0.50);
+        result->p99 = percentile(inject_ns, count, 0.99);
+        result->p999 = percentile(inject_ns, count, 0.999);
+        result->max = inject_ns[count - 1];
+    }
+
+    capacity = 0;
+    free(dispatch_ns);
+    dispatch_ns = NULL;
+    free(inject_ns);
+}
+
+static void print_result(const char *name, unsigned int rate, const bench_result *result) {
+    char target[16];
+    if (rate > 0) {
+        snprintf(target, sizeof(target), "%u", rate);
+    } else {
+        snprintf(target, sizeof(target), "max");
+    }
+
+    fprintf(stdout, "%-7s %7s %9.0f %7" PRIu64 " %7" PRIu64 " %9.1f %9.1f %9.1f %9.1f %9.0f %9.0f %9.0f\n",
+            name, target, result->achieved_rate, result->sent, result->received,
+            result->p50 / 1e3, result->p99 / 1e3, result->p999 / 1e3, result->max / 1e3,
+            result->hook_cpu, result->process_cpu, result->server_cpu);
+}
+
+// Injection throughput of single posts against hook_post_events() batches.
+static void run_post_throughput(unsigned int count) {
+    uiohook_event *batch = calloc(POST_BATCH_SIZE, sizeof(uiohook_event));
+    if (batch == NULL) {
+        return;
+    }
+
+    for (unsigned int i = 0; i < POST_BATCH_SIZE; i++) {
+        batch[i].type = EVENT_MOUSE_MOVED;
+        batch[i].data.mouse.x = (i & 1) ? 500 : 501;
+        batch[i].data.mouse.y = 500;
+    }
+
+    uint64_t start = now_ns();
+    for (unsigned int i = 0; i < count; i++) {
+        hook_post_event(&batch[i % POST_BATCH_SIZE]);
+    }
+    double single = count / ((now_ns() - start) / 1e9);
+
+    start = now_ns();
+    for (unsigned int i = 0; i < count; i += POST_BATCH_SIZE) {
+        hook_post_events(batch, POST_BATCH_SIZE, 0);
+    }
+    double batched = count / ((now_ns() - start) / 1e9);
+
+    fprintf(stdout, "Post throughput: %.0f events/sec single, %.0f events/sec in batches of %u\n",
+            single, batched, POST_BATCH_SIZE);
+
+    // Text typed one key event at a time against a whole string per call.
+    char text[POST_BATCH_SIZE + 1];
+    for (unsigned int i = 0; i < POST_BATCH_SIZE; i++) {
+        text[i] = (char) ('a' + i % 26);
+    }
+    text[POST_BATCH_SIZE] = '\0';
+
+    batch[0].type = EVENT_KEY_PRESSED;
+    batch[0].data.keyboard.keycode = VC_A;
+    batch[1].type = EVENT_KEY_RELEASED;
+    batch[1].data.keyboard.keycode = VC_A;
+
+    start = now_ns();
+    for (unsigned int i = 0; i < count; i++) {
+        hook_post_event(&batch[0]);
+        hook_post_event(&batch[1]);
+    }
+    single = count / ((now_ns() - start) / 1e9);
+
+    start = now_ns();
+    for (unsigned int i = 0; i < count; i += POST_BATCH_SIZE) {
+        hook_post_text(text);
+    }
+    batched = count / ((now_ns() - start) / 1e9);
+
+    fprintf(stdout, "Text throughput: %.0f chars/sec with single key posts, %.0f chars/sec with hook_post_text\n",
+            single, batched);
+
+    free(batch);
+}
+
+// Body of a startup launch, reports when main(), the hook and the first event were reached.
+static int run_startup_child(int fd, uint64_t main_ns) {
+    static uint64_t first_ns = 0;
+    dispatch_ns = &first_ns;
+    capacity = 1;
+    __atomic_store_n(&current_match, EVENT_KEY_PRESSED, __ATOMIC_RELEASE);
+
+    int status = UIOHOOK_FAILURE;
+    pthread_t hook_thread;
+    if (!start_hook(&hook_thread, &status)) {
+        return EXIT_FAILURE;
+    }
+
+    post(&kinds[0], 0);
+
+    uint64_t deadline = now_ns() + BENCH_DRAIN_NS;
+    while (__atomic_load_n(&received, __ATOMIC_ACQUIRE) == 0 && now_ns() < deadline) {
+        struct timespec delay = { 0, 100000 };
+        nanosleep(&delay, NULL);
+    }
+
+    bool seen = __atomic_load_n(&received, __ATOMIC_ACQUIRE) > 0;
+    if (seen) {
+        uint64_t times[3] = { main_ns, __atomic_load_n(&enabled_ns, __ATOMIC_RELAXED), first_ns };
+        seen = write(fd, times, sizeof(times)) == sizeof(times);
+    }
+    close(fd);
+
+    hook_stop();
+    pthread_join(hook_thread, NULL);
+
+    return seen ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+// Launch the benchmark runs times and report the time from fork() to each startup milestone.
+static bool run_startup(unsigned int runs, char *argv[]) {
+    static const char *milestones[] = { "main", "hook enabled", "first event" };
+    uint64_t *samples = malloc(sizeof(uint64_t) * 3 * runs);
+    if (samples == NULL) {
+        return false;
+    }
+
+    for (unsigned int r = 0; r < runs; r++) {
+        int fds[2];
+        if (pipe(fds) != 0) {
+            free(samples);
+            return false;
+        }
+
+        uint64_t launch = now_ns();
+        pid_t pid = fork();
+        if (pid == 0) {
+            close(fds[0]);
+
+            char fd[16];
+            snprintf(fd, sizeof(fd), "%d", fds[1]);
+            setenv(STARTUP_FD_ENV, fd, 1);
+
+            execv("/proc/self/exe", argv);
+            execvp(argv[0], argv);
+            _exit(127);
+        }
+        close(fds[1]);
+
+        uint64_t times[3];
+        size_t length = 0;
+        struct pollfd pfd = { fds[0], POLLIN, 0 };
+        while (pid > 0 && length < sizeof(times) && poll(&pfd, 1, BENCH_START_NS / 1000000) > 0) {
+            ssize_t n = read(fds[0], (char *) times + length, sizeof(times) - length);
+            if (n <= 0) {
+                break;
+            }
+            length += (size_t) n;
+        }
+        close(fds[0]);
+
+        if (pid > 0) {
+            waitpid(pid, NULL, 0);
+        }
+
+        if (length != sizeof(times)) {
+            fprintf(stderr, "Startup launch %u did not receive an event!\n", r);
+            free(samples);
+            return false;
+        }
+
+        for (unsigned int m = 0; m < 3; m++) {
+            samples[m * runs + r] = times[m] - launch;
+        }
+    }
+
+    fprintf(stdout, "%-13s %9s %9s %9s\n", "startup", "p50 us", "min us", "max us");
+    for (unsigned int m = 0; m < 3; m++) {
+        uint64_t *sorted = &samples[m * runs];
+        qsort(sorted, runs, sizeof(uint64_t), compare_uint64);
+
+        fprintf(stdout, "%-13s %9.1f %9.1f %9.1f\n", milestones[m],
+                percentile(sorted, runs, 0.50) / 1e3, sorted[0] / 1e3, sorted[runs - 1] / 1e3);
+    }
+    fflush(stdout);
+
+    free(samples);
+
+    return true;
+}
+
+#ifdef USE_XKB_KEYMAP_CACHE
+// Remove the keymap cache entries written under directory.
+static void clear_keymap_cache(const char *directory) {
+    char path[PATH_MAX];
+    snprintf(path, sizeof(path), "%s/libuiohook", directory);
+
+    DIR *dir = opendir(path);
+    if (dir != NULL) {
+        struct dirent *entry;
+        while ((entry = readdir(dir)) != NULL) {
+            if (strcmp(entry->d_name, ".") != 0 && strcmp(entry->d_name, "..") != 0) {
+                char file[PATH_MAX];
+                if (snprintf(file, sizeof(file), "%s/%s", path, entry->d_name) < (int) sizeof(file)) {
+                    unlink(file);
+                }
+            }
+        }
+        closedir(dir);
+    }
+}
+
+// Time create_xkb_state() with an empty keymap cache and with a warm one.
+static bool run_keymap_startup(unsigned int runs) {
+    static const char *starts[] = { "cold", "warm" };
+
+    Display *display = XOpenDisplay(NULL);
+    if (display == NULL) {
+        fprintf(stderr, "Failed to open the display for the keymap benchmark!\n");
+        return false;
+    }
+
+    xcb_connection_t *connection = XGetXCBConnection(display);
+    struct xkb_context *context = xkb_context_new(XKB_CONTEXT_NO_FLAGS);
+
+    char directory[] = "/tmp/uiohook-bench-XXXXXX";
+    uint64_t *samples = malloc(sizeof(uint64_t) * 2 * runs);
+    if (context == NULL || samples == NULL || mkdtemp(directory) == NULL) {
+        fprintf(stderr, "Failed to prepare the keymap benchmark!\n");
+        free(samples);
+        xkb_context_unref(context);
+        XCloseDisplay(display);
+        return false;
+    }
+
+    // The cache lives in a private directory so the user's cache is left alone.
+    char *cache_home = getenv("XDG_CACHE_HOME") != NULL ? strdup(getenv("XDG_CACHE_HOME")) : NULL;
+    setenv("XDG_CACHE_HOME", directory, 1);
+
+    bool created = true;
+    for (unsigned int r = 0; r < runs && created; r++) {
+        clear_keymap_cache(directory);
+
+        for (unsigned int s = 0; s < 2 && created; s++) {
+            uint64_t start = now_ns();
+            struct xkb_state *state = create_xkb_state(context, connection);
+            samples[s * runs + r] = now_ns() - start;
+
+            created = state != NULL;
+            destroy_xkb_state(state);
+        }
+    }
+
+    clear_keymap_cache(directory);
+    char path[PATH_MAX];
+    snprintf(path, sizeof(path), "%s/libuiohook", directory);
+    rmdir(path);
+    rmdir(directory);
+
+    if (cache_home != NULL) {
+        setenv("XDG_CACHE_HOME", cache_home, 1);
+        free(cache_home);
+    } else {
+        unsetenv("XDG_CACHE_HOME");
+    }
+
+    xkb_context_unref(context);
+    XCloseDisplay(display);
+
+    if (!created) {
+        fprintf(stderr, "Failed to create the keyboard state!\n");
+        free(samples);
+        return false;
+    }
+
+    fprintf(stdout, "%-13s %9s %9s %9s\n", "keymap", "p50 us", "min us", "max us");
+    for (unsigned int s = 0; s < 2; s++) {
+        uint64_t *sorted = &samples[s * runs];
+        qsort(sorted, runs, sizeof(uint64_t), compare_uint64);
+
+        fprintf(stdout, "%-13s %9.1f %9.1f %9.1f\n", starts[s],
+                percentile(sorted, runs, 0.50) / 1e3, sorted[0] / 1e3, sorted[runs - 1] / 1e3);
+    }
+    fflush(stdout);
+
+    free(samples);
+
+    return true;
+}
+#endif
+
+static int run_benchmark(unsigned int count, unsigned int rate, bool ramp, unsigned int startup,
+        unsigned int keymap, char *argv[]) {
+    // Launches must not overlap with the hook of this process.
+    if (startup > 0 && !run_startup(startup, argv)) {
+        return EXIT_FAILURE;
+    }
+
+    #ifdef USE_XKB_KEYMAP_CACHE
+    // Before the hook starts, every call publishes new key translations.
+    if (keymap > 0 && !run_keymap_startup(keymap)) {
+        return EXIT_FAILURE;
+    }
+    #endif
+
+    int status = UIOHOOK_FAILURE;
+    pthread_t hook_thread;
+    if (!start_hook(&hook_thread, &status)) {
+        return EXIT_FAILURE;
+    }
+
+    pid_t server = 0;
+    if (getenv(XVFB_PID_ENV) != NULL) {
+        server = (pid_t) atoi(getenv(XVFB_PID_ENV));
+    }
+
+    fprintf(stdout, "%-7s %7s %9s %7s %7s %9s %9s %9s %9s %9s %9s %9s\n",
+            "event", "rate", "achieved", "sent", "recv", "p50 us", "p99 us", "p99.9 us", "max us",
+            "hook ns", "proc ns", "X ns");
+
+    bench_result result;
+    for (unsigned int k = 0; k < sizeof(kinds) / sizeof(kinds[0]); k++) {
+        run(&kinds[k], count, rate, hook_thread, server, &result);
+        print_result(kinds[k].name, rate, &result);
+    }
+
+    if (ramp) {
+        // Highest achieved rate without losing a single event.
+        double sustained = 0;
+        for (unsigned int r = 0; r < sizeof(ramp_rates) / sizeof(ramp_rates[0]); r++) {
+            run(&kinds[2], count, ramp_rates[r], hook_thread, server, &result);
+            print_result("ramp", ramp_rates[r], &result);
+
+            if (result.received != result.sent) {
+                break;
+            }
+            sustained = result.achieved_rate;
+        }
+
+        fprintf(stdout, "Max sustained motion throughput: %.0f events/sec\n", sustained);
+    }
+
+    run_post_throughput(count);
+
+    hook_stop();
+    pthread_join(hook_thread, NULL);
+
+    return EXIT_SUCCESS;
+}
+
+// Start a private Xvfb and return its pid, the display name is written to display.
+static pid_t start_xvfb(char *display, size_t size) {
+    int fds[2];
+    if (pipe(fds) != 0) {
+        return -1;
+    }
+
+    pid_t pid = fork();
+    if (pid == 0) {
+        close(fds[0]);
+
+        char fd[16];
+        snprintf(fd, sizeof(fd), "%d", fds[1]);
+        execlp("Xvfb", "Xvfb", "-displayfd", fd, "-screen", "0", "1920x1080x24", "-nolisten", "tcp", (char *) NULL);
+        _exit(127);
+    }
+    close(fds[1]);
+
+    if (pid < 0) {
+        close(fds[0]);
+        return -1;
+    }
+
+    // Xvfb writes the display number it picked once it is ready.
+    char number[16];
+    size_t length = 0;
+    struct pollfd pfd = { fds[0], POLLIN, 0 };
+    while (length < sizeof(number) - 1 && poll(&pfd, 1, BENCH_START_NS / 1000000) > 0) {
+        ssize_t n = read(fds[0], number + length, 1);
+        if (n <= 0 || number[length] == '\n') {
+            break;
+        }
+        length++;
+    }
+    number[length] = '\0';
+    close(fds[0]);
+
+    if (length == 0) {
+        kill(pid, SIGTERM);
+        waitpid(pid, NULL, 0);
+        return -1;
+    }
+
+    snprintf(display, size, ":%s", number);
+
+    return pid;
+}
+
+static void usage(const char *name) {
+    fprintf(stderr, "Usage: %s [--events N] [--rate R] [--startup N] [--keymap N] [--no-ramp] [--no-xvfb]\n", name);
+    fprintf(stderr, "  --events N   events injected per measurement (default: %u)\n", BENCH_EVENTS);
+    fprintf(stderr, "  --rate R     injection rate in events/sec, 0 is unthrottled (default: %u)\n", BENCH_RATE);
+    fprintf(stderr, "  --startup N  launches timed from fork() to the first event, 0 skips (default: %u)\n", STARTUP_RUNS);
+    fprintf(stderr, "  --keymap N   cold and warm keymap cache loads timed with USE_XKB_KEYMAP_CACHE, 0 skips (default: %u)\n", KEYMAP_RUNS);
+    fprintf(stderr, "  --no-ramp    skip the maximum throughput search\n");
+    fprintf(stderr, "  --no-xvfb    use the current DISPLAY instead of a private Xvfb\n");
+}
+
+int main(int argc, char *argv[]) {
+    uint64_t main_ns = now_ns();
+    if (getenv(STARTUP_FD_ENV) != NULL) {
+        return run_startup_child(atoi(getenv(STARTUP_FD_ENV)), main_ns);
+    }
+
+    unsigned int count = BENCH_EVENTS, rate = BENCH_RATE, startup = STARTUP_RUNS, keymap = KEYMAP_RUNS;
+    bool ramp = true, xvfb = true;
+
+    static const struct option options[] = {
+        { "events",  required_argument, NULL, 'n' },
+        { "rate",    required_argument, NULL, 'r' },
+        { "startup", required_argument, NULL, 's' },
+        { "keymap",  required_argument, NULL, 'k' },
+        { "no-ramp", no_argument,       NULL, 'R' },
+        { "no-xvfb", no_argument,       NULL, 'X' },
+        { "help",    no_argument,       NULL, 'h' },
+        { NULL, 0, NULL, 0 }
+    };
+
+    int option;
+    while ((option = getopt_long(argc, argv, "n:r:s:k:h", options, NULL)) != -1) {
+        switch (option) {
+            case 'n': count = (unsigned int) strtoul(optarg, NULL, 10); break;
+            case 'r': rate = (unsigned int) strtoul(optarg, NULL, 10); break;
+            case 's': startup = (unsigned int) strtoul(optarg, NULL, 10); break;
+            case 'k': keymap = (unsigned int) strtoul(optarg, NULL, 10); break;
+            case 'R': ramp = false; break;
+            case 'X': xvfb = false; break;
+            default:
+                usage(argv[0]);
+                return option == 'h' ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+
+    if (count == 0) {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    if (!xvfb || getenv(CHILD_ENV) != NULL) {
+        return run_benchmark(count, rate, ramp, startup, keymap, argv);
+    }
+
+    char display[32];
+    pid_t server = start_xvfb(display, sizeof(display));
+    if (server < 0) {
+        fprintf(stderr, "Failed to start Xvfb, is it installed?\n");
+        return EXIT_FAILURE;
+    }
+
+    char server_pid[16];
+    snprintf(server_pid, sizeof(server_pid), "%d", (int) server);
+    setenv("DISPLAY", display, 1);
+    setenv(CHILD_ENV, "1", 1);
+    setenv(XVFB_PID_ENV, server_pid, 1);
+
+    fprintf(stdout, "Started Xvfb on %s (pid %s)\n", display, server_pid);
+    fflush(stdout);
+
+    int status = EXIT_FAILURE;
+    pid_t child = fork();
+    if (child == 0) {
+        // Re-execute so nothing in this process has touched the old display.
+        execv("/proc/self/exe", argv);
+        execvp(argv[0], argv);
+        _exit(127);
+    } else if (child > 0) {
+        int child_status;
+        if (waitpid(child, &child_status, 0) == child && WIFEXITED(child_status)) {
+            status = WEXITSTATUS(child_status);
+        }
+    }
+
+    kill(server, SIGTERM);
+    waitpid(server, NULL, 0);
+
+    return status;
+}
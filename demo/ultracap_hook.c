@@ -24,11 +24,113 @@
 #include <stdarg.h>
 #include <stdbool.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <uiohook.h>
 #include <wchar.h>
 #include <time.h>
 
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#endif
+
+/* Binary output format, selected with --format=binary.  All integers are
+ * little-endian.  The stream starts with a 16 byte header:
+ *
+ *   0  uint32  magic, "UIOH"
+ *   4  uint16  format version, currently 1
+ *   6  uint16  header size in bytes, records start here
+ *   8  uint16  record size in bytes
+ *  10  6 bytes reserved, zero
+ *
+ * followed by one record per event, 32 bytes each so a reader can view the
+ * stream as an array and 64-bit fields stay aligned:
+ *
+ *   0  uint8   event type, see event_type in uiohook.h
+ *   1  uint8   reserved
+ *   2  uint16  modifier mask
+ *   4  uint32  reserved
+ *   8  uint64  event time
+ *  16  payload, 16 bytes, unused bytes are zero
+ *
+ * Keyboard events:   uint16 keycode, uint16 rawcode, uint16 keychar
+ * Mouse events:      uint16 button, uint16 clicks, int16 x, int16 y
+ * Mouse wheel:       uint16 clicks, int16 x, int16 y, uint8 type,
+ *                    uint8 direction, uint16 amount, int16 rotation
+ *
+ * Readers must skip header size bytes and step by record size so that fields
+ * appended by later versions can be ignored.
+ */
+#define BINARY_MAGIC        0x484F4955
+#define BINARY_VERSION      1
+#define BINARY_HEADER_SIZE  16
+#define BINARY_RECORD_SIZE  32
+
+// Longest text or JSON line, including the line feed.
+#define TEXT_RECORD_SIZE    (UIOHOOK_JSON_MAX_SIZE + 1)
+
+#ifdef __linux__
+#include <errno.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+#define WRITER_QUEUE_SIZE   65536
+
+/* Buffered writer, enabled with --flush-us.  Records are formatted off the
+ * hook thread and written once flush_bytes have accumulated or flush_us after
+ * the oldest unwritten record, whichever comes first.
+ */
+static size_t flush_bytes = 65536;
+static unsigned long flush_us = 0;
+
+// Signaled by the hook thread once hook_run() returns.
+static int done_fd = -1;
+static int hook_status = UIOHOOK_FAILURE;
+
+// Event and the time dispatch_proc() received it, the writer formats it later.
+typedef struct _stamped_event {
+    uiohook_event event;
+    long long timestamp;
+} stamped_event;
+
+/* Events handed from dispatch_proc() to the writer.  The writer swaps the
+ * pending array for an empty one and pending_fd is readable while it has
+ * events.  Only used while writer_running is set.
+ */
+static stamped_event *pending = NULL;
+static size_t pending_count = 0;
+static bool writer_running = false;
+static int pending_fd = -1;
+static pthread_mutex_t pending_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t pending_cond = PTHREAD_COND_INITIALIZER;
+#endif
+
+typedef enum _output_format {
+    FORMAT_TEXT,
+    FORMAT_JSON,
+    FORMAT_BINARY
+} output_format;
+
+// Selected with --format.
+static output_format format = FORMAT_TEXT;
+
+#ifdef USE_SHM
+#include <signal.h>
+#include <sys/mman.h>
+#include <uiohook_shm.h>
+#include <unistd.h>
+
+#define SHM_CAPACITY 65536
+
+// Ring written by dispatch_proc() when started with --shm.
+static uiohook_shm *shm = NULL;
+static const char *shm_name = NULL;
+#endif
+
 long long getTimeStampInMilliseconds() {
     time_t currentTime;
     struct timespec spec;
@@ -69,36 +171,28 @@ bool logger_proc(unsigned int level, const char *format, ...) {
     return status;
 }
 
-// NOTE: The following callback executes on the same thread that hook_run() is called 
-// from.  This is important because hook_run() attaches to the operating systems
-// event dispatcher and may delay event delivery to the target application.
-// Furthermore, some operating systems may choose to disable your hook if it 
-// takes too long to process.  If you need to do any extended processing, please 
-// do so by copying the event to your own queued dispatch thread.
-void dispatch_proc(uiohook_event * const event) {
-
+/* Format the event as a JavaScript object literal line, returns its length.
+ * The timestamp is the JS compatible time the event was received at.
+ */
+static size_t format_text(const uiohook_event * const event, long long timestamp, char *buffer, size_t size) {
     // Diabling this as weird characters like `\r\ in `keychar` 
     // interferes with JSON.parse() over at Electron
 
     if (event->type != EVENT_KEY_TYPED){
-        char buffer[256] = { 0 };
-
-        // JS Compatible timestamp
-        long long timestamp = getTimeStampInMilliseconds();
-        size_t length = snprintf(buffer, sizeof(buffer), 
+        size_t length = snprintf(buffer, size, 
                 "{id:%i,when:%" PRIu64 ",mask:0x%X,time:%lld", 
                 event->type, event->time, event->mask, timestamp);
 
 
         switch (event->type) {
             case EVENT_KEY_PRESSED:
-                snprintf(buffer + length, sizeof(buffer) - length, 
+                snprintf(buffer + length, size - length, 
                     ",keycode:%u,rawcode:0x%X,event:'KEY_PRESSED'",
                     event->data.keyboard.keycode, event->data.keyboard.rawcode);
                 break;
 
             case EVENT_KEY_RELEASED:
-                snprintf(buffer + length, sizeof(buffer) - length, 
+                snprintf(buffer + length, size - length, 
                     ",keycode:%u,rawcode:0x%X,event:'KEY_RELEASED'",
                     event->data.keyboard.keycode, event->data.keyboard.rawcode);
                 break;
@@ -106,45 +200,45 @@ void dispatch_proc(uiohook_event * const event) {
             // Diabling this as weird characters like `\r\ in `keychar` 
             // interferes with JSON.parse() over at Electron
             // case EVENT_KEY_TYPED:
-            //     snprintf(buffer + length, sizeof(buffer) - length, 
+            //     snprintf(buffer + length, size - length, 
             //         ",keychar:'%lc',rawcode:%u,event:'KEY_TYPED'",
             //         (wint_t) event->data.keyboard.keychar,
             //         event->data.keyboard.rawcode);
             //     break;
 
             case EVENT_MOUSE_PRESSED:
-                snprintf(buffer + length, sizeof(buffer) - length, 
+                snprintf(buffer + length, size - length, 
                     ",x:%i,y:%i,button:%i,clicks:%i,event:'MOUSE_PRESSED'",
                     event->data.mouse.x, event->data.mouse.y,
                     event->data.mouse.button, event->data.mouse.clicks);
                 break;
             case EVENT_MOUSE_RELEASED:
-                snprintf(buffer + length, sizeof(buffer) - length, 
+                snprintf(buffer + length, size - length, 
                     ",x:%i,y:%i,button:%i,clicks:%i,event:'MOUSE_RELEASED'",
                     event->data.mouse.x, event->data.mouse.y,
                     event->data.mouse.button, event->data.mouse.clicks);
                 break;
             case EVENT_MOUSE_CLICKED:
-                snprintf(buffer + length, sizeof(buffer) - length, 
+                snprintf(buffer + length, size - length, 
                     ",x:%i,y:%i,button:%i,clicks:%i,event:'MOUSE_CLICKED'",
                     event->data.mouse.x, event->data.mouse.y,
                     event->data.mouse.button, event->data.mouse.clicks);
                 break;
             case EVENT_MOUSE_MOVED:
-                snprintf(buffer + length, sizeof(buffer) - length, 
+                snprintf(buffer + length, size - length, 
                     ",x:%i,y:%i,button:%i,clicks:%i,event:'MOUSE_MOVED'",
                     event->data.mouse.x, event->data.mouse.y,
                     event->data.mouse.button, event->data.mouse.clicks);
                 break;
             case EVENT_MOUSE_DRAGGED:
-                snprintf(buffer + length, sizeof(buffer) - length, 
+                snprintf(buffer + length, size - length, 
                     ",x:%i,y:%i,button:%i,clicks:%i,event:'MOUSE_DRAGGED'",
                     event->data.mouse.x, event->data.mouse.y,
                     event->data.mouse.button, event->data.mouse.clicks);
                 break;
 
             case EVENT_MOUSE_WHEEL:
-                snprintf(buffer + length, sizeof(buffer) - length, 
+                snprintf(buffer + length, size - length, 
                     ",type:%i,amount:%i,rotation:%i,event:'MOUSE_WHEEL'",
                     event->data.wheel.type, event->data.wheel.amount,
                     event->data.wheel.rotation);
@@ -154,14 +248,443 @@ void dispatch_proc(uiohook_event * const event) {
                 break;
         } 
 
-        fprintf(stdout, "%s}\n",     buffer);
+        length += strlen(buffer + length);
+        length += snprintf(buffer + length, size - length, "}\n");
+
+        return length;
+    }
+    
+    return 0;
+}
+
+static void write_text(uiohook_event * const event) {
+    char buffer[TEXT_RECORD_SIZE];
+    size_t length = format_text(event, getTimeStampInMilliseconds(), buffer, sizeof(buffer));
+    if (length > 0) {
+        fwrite(buffer, length, 1, stdout);
         // Without this, Node JS's spawn is not able to pickup information in realtime.
         fflush(stdout);
     }
-    
 }
 
-int main() {
+static void put_uint16(uint8_t *buffer, uint16_t value) {
+    buffer[0] = (uint8_t) value;
+    buffer[1] = (uint8_t) (value >> 8);
+}
+
+static void put_uint32(uint8_t *buffer, uint32_t value) {
+    put_uint16(buffer, (uint16_t) value);
+    put_uint16(buffer + 2, (uint16_t) (value >> 16));
+}
+
+static void put_uint64(uint8_t *buffer, uint64_t value) {
+    put_uint32(buffer, (uint32_t) value);
+    put_uint32(buffer + 4, (uint32_t) (value >> 32));
+}
+
+// Write the stream header described at BINARY_MAGIC.
+static void write_binary_header() {
+    uint8_t header[BINARY_HEADER_SIZE] = { 0 };
+    put_uint32(header, BINARY_MAGIC);
+    put_uint16(header + 4, BINARY_VERSION);
+    put_uint16(header + 6, BINARY_HEADER_SIZE);
+    put_uint16(header + 8, BINARY_RECORD_SIZE);
+
+    fwrite(header, sizeof(header), 1, stdout);
+    fflush(stdout);
+}
+
+// Encode the event as one fixed size little-endian record.
+static size_t encode_binary(const uiohook_event * const event, uint8_t *record) {
+    memset(record, 0, BINARY_RECORD_SIZE);
+    record[0] = (uint8_t) event->type;
+    put_uint16(record + 2, event->mask);
+    put_uint64(record + 8, event->time);
+
+    uint8_t *payload = record + 16;
+    switch (event->type) {
+        case EVENT_KEY_TYPED:
+        case EVENT_KEY_PRESSED:
+        case EVENT_KEY_RELEASED:
+            put_uint16(payload, event->data.keyboard.keycode);
+            put_uint16(payload + 2, event->data.keyboard.rawcode);
+            put_uint16(payload + 4, event->data.keyboard.keychar);
+            break;
+
+        case EVENT_MOUSE_CLICKED:
+        case EVENT_MOUSE_PRESSED:
+        case EVENT_MOUSE_RELEASED:
+        case EVENT_MOUSE_MOVED:
+        case EVENT_MOUSE_DRAGGED:
+            put_uint16(payload, event->data.mouse.button);
+            put_uint16(payload + 2, event->data.mouse.clicks);
+            put_uint16(payload + 4, (uint16_t) event->data.mouse.x);
+            put_uint16(payload + 6, (uint16_t) event->data.mouse.y);
+            break;
+
+        case EVENT_MOUSE_WHEEL:
+            put_uint16(payload, event->data.wheel.clicks);
+            put_uint16(payload + 2, (uint16_t) event->data.wheel.x);
+            put_uint16(payload + 4, (uint16_t) event->data.wheel.y);
+            payload[6] = event->data.wheel.type;
+            payload[7] = event->data.wheel.direction;
+            put_uint16(payload + 8, event->data.wheel.amount);
+            put_uint16(payload + 10, (uint16_t) event->data.wheel.rotation);
+            break;
+
+        default:
+            break;
+    }
+
+    return BINARY_RECORD_SIZE;
+}
+
+// Format the event as one line of JSON, returns its length.
+static size_t format_json(const uiohook_event * const event, char *buffer, size_t size) {
+    size_t length = hook_event_to_json(event, buffer, size - 1);
+    buffer[length++] = '\n';
+
+    return length;
+}
+
+static void write_json(uiohook_event * const event) {
+    char buffer[TEXT_RECORD_SIZE];
+    fwrite(buffer, format_json(event, buffer, sizeof(buffer)), 1, stdout);
+    fflush(stdout);
+}
+
+static void write_binary(uiohook_event * const event) {
+    uint8_t record[BINARY_RECORD_SIZE];
+    fwrite(record, encode_binary(event, record), 1, stdout);
+    fflush(stdout);
+}
+
+#ifdef __linux__
+// Hand the event to the writer thread, stamped with the time it was received.
+static void queue_event(uiohook_event * const event) {
+    long long timestamp = getTimeStampInMilliseconds();
+
+    pthread_mutex_lock(&pending_mutex);
+
+    // Block rather than drop, like the unbuffered writer does on a full pipe.
+    while (writer_running && pending_count == WRITER_QUEUE_SIZE) {
+        pthread_cond_wait(&pending_cond, &pending_mutex);
+    }
+
+    if (writer_running) {
+        pending[pending_count].event = *event;
+        pending[pending_count].timestamp = timestamp;
+
+        if (pending_count++ == 0) {
+            uint64_t value = 1;
+            while (write(pending_fd, &value, sizeof(value)) < 0 && errno == EINTR);
+        }
+    }
+
+    pthread_mutex_unlock(&pending_mutex);
+}
+#endif
+
+// NOTE: The following callback executes on the same thread that hook_run() is called 
+// from.  This is important because hook_run() attaches to the operating systems
+// event dispatcher and may delay event delivery to the target application.
+// Furthermore, some operating systems may choose to disable your hook if it 
+// takes too long to process.  If you need to do any extended processing, please 
+// do so by copying the event to your own queued dispatch thread.
+void dispatch_proc(uiohook_event * const event) {
+    #ifdef USE_SHM
+    if (shm != NULL) {
+        // No formatting or system call unless the reader is asleep.
+        uiohook_shm_write(shm, event);
+        return;
+    }
+    #endif
+
+    #ifdef __linux__
+    if (flush_us > 0) {
+        queue_event(event);
+        return;
+    }
+    #endif
+
+    switch (format) {
+        case FORMAT_BINARY:
+            write_binary(event);
+            break;
+
+        case FORMAT_JSON:
+            write_json(event);
+            break;
+
+        default:
+            write_text(event);
+            break;
+    }
+}
+
+#ifdef __linux__
+static void *hook_thread_proc(void *arg) {
+    hook_status = hook_run();
+
+    uint64_t value = 1;
+    while (write(done_fd, &value, sizeof(value)) < 0 && errno == EINTR);
+
+    return NULL;
+}
+
+// Write the whole buffer to stdout.
+static bool flush_buffer(const char *buffer, size_t *length) {
+    size_t offset = 0;
+    while (offset < *length) {
+        ssize_t count = write(STDOUT_FILENO, buffer + offset, *length - offset);
+        if (count < 0 && errno != EINTR) {
+            logger_proc(LOG_LEVEL_ERROR, "Failed to write events. (%d)\n", errno);
+            return false;
+        } else if (count > 0) {
+            offset += (size_t) count;
+        }
+    }
+    *length = 0;
+
+    return true;
+}
+
+static void arm_timer(int timer_fd, unsigned long usec) {
+    struct itimerspec timer = { { 0, 0 }, { 0, 0 } };
+    timer.it_value.tv_sec = usec / 1000000;
+    timer.it_value.tv_nsec = (long) (usec % 1000000) * 1000;
+
+    timerfd_settime(timer_fd, 0, &timer, NULL);
+}
+
+/* Run the hook on its own thread and write its events from this one.  The
+ * hook thread only stamps and copies events into the pending array.
+ */
+static int run_writer() {
+    size_t size = flush_bytes + (format == FORMAT_BINARY ? BINARY_RECORD_SIZE : TEXT_RECORD_SIZE);
+    char *buffer = malloc(size);
+    stamped_event *events = malloc(sizeof(stamped_event) * WRITER_QUEUE_SIZE);
+    pending = malloc(sizeof(stamped_event) * WRITER_QUEUE_SIZE);
+    if (buffer == NULL || events == NULL || pending == NULL) {
+        free(buffer);
+        free(events);
+        free(pending);
+        pending = NULL;
+        return UIOHOOK_ERROR_OUT_OF_MEMORY;
+    }
+
+    pending_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    int timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC | TFD_NONBLOCK);
+    done_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    writer_running = true;
+
+    pthread_t hook_thread;
+    if (pending_fd < 0 || timer_fd < 0 || done_fd < 0
+            || pthread_create(&hook_thread, NULL, hook_thread_proc, NULL) != 0) {
+        logger_proc(LOG_LEVEL_ERROR, "Failed to start the writer. (%d)\n", errno);
+
+        writer_running = false;
+        if (pending_fd >= 0) {
+            close(pending_fd);
+            pending_fd = -1;
+        }
+        if (timer_fd >= 0) {
+            close(timer_fd);
+        }
+        if (done_fd >= 0) {
+            close(done_fd);
+            done_fd = -1;
+        }
+        free(buffer);
+        free(events);
+        free(pending);
+        pending = NULL;
+        return UIOHOOK_FAILURE;
+    }
+
+    struct pollfd fds[3] = {
+        { pending_fd, POLLIN, 0 },
+        { timer_fd,   POLLIN, 0 },
+        { done_fd,    POLLIN, 0 }
+    };
+
+    size_t length = 0;
+    bool armed = false, running = true, written = true;
+    uint64_t value;
+    while (running && written) {
+        if (poll(fds, 3, -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+
+        if (fds[2].revents & POLLIN) {
+            // Drain what was queued before the hook stopped, then exit.
+            running = false;
+        }
+
+        // Take everything queued so far and let a blocked hook thread continue.
+        while (read(pending_fd, &value, sizeof(value)) < 0 && errno == EINTR);
+        pthread_mutex_lock(&pending_mutex);
+        stamped_event *queued = pending;
+        size_t count = pending_count;
+        pending = events;
+        pending_count = 0;
+        pthread_cond_signal(&pending_cond);
+        pthread_mutex_unlock(&pending_mutex);
+        events = queued;
+
+        for (size_t i = 0; i < count && written; i++) {
+            if (format == FORMAT_BINARY) {
+                length += encode_binary(&events[i].event, (uint8_t *) buffer + length);
+            } else if (format == FORMAT_JSON) {
+                length += format_json(&events[i].event, buffer + length, size - length);
+            } else {
+                length += format_text(&events[i].event, events[i].timestamp, buffer + length, size - length);
+            }
+
+            if (length >= flush_bytes) {
+                written = flush_buffer(buffer, &length);
+            }
+        }
+
+        if (written && (fds[1].revents & POLLIN)) {
+            while (read(timer_fd, &value, sizeof(value)) < 0 && errno == EINTR);
+            armed = false;
+
+            written = flush_buffer(buffer, &length);
+        }
+
+        // Bound the latency of the oldest unwritten record.
+        if (length > 0 && !armed) {
+            arm_timer(timer_fd, flush_us);
+            armed = true;
+        } else if (length == 0 && armed) {
+            arm_timer(timer_fd, 0);
+            armed = false;
+        }
+    }
+
+    if (written) {
+        written = flush_buffer(buffer, &length);
+    }
+
+    // Nothing more can be written, release the hook thread and stop the hook.
+    pthread_mutex_lock(&pending_mutex);
+    writer_running = false;
+    pthread_cond_signal(&pending_cond);
+    pthread_mutex_unlock(&pending_mutex);
+
+    // Stop the hook if the loop ended first, retrying while it may still be starting.
+    struct pollfd done = { done_fd, POLLIN, 0 };
+    while (running && hook_stop() != UIOHOOK_SUCCESS && poll(&done, 1, 10) == 0);
+
+    pthread_join(hook_thread, NULL);
+
+    close(pending_fd);
+    pending_fd = -1;
+    close(timer_fd);
+    close(done_fd);
+    done_fd = -1;
+
+    free(buffer);
+    free(events);
+    free(pending);
+    pending = NULL;
+
+    return written ? hook_status : UIOHOOK_FAILURE;
+}
+#endif
+
+#ifdef USE_SHM
+// Remove the ring name so it does not outlive us, shm_unlink() is async signal safe.
+static void signal_proc(int signal) {
+    shm_unlink(shm_name);
+    _exit(128 + signal);
+}
+
+static bool open_shm(const char *name) {
+    shm = uiohook_shm_create(name, SHM_CAPACITY);
+    if (shm == NULL) {
+        logger_proc(LOG_LEVEL_ERROR, "Failed to create shared memory ring %s.\n", name);
+        return false;
+    }
+    shm_name = name;
+
+    signal(SIGINT, signal_proc);
+    signal(SIGTERM, signal_proc);
+    signal(SIGHUP, signal_proc);
+
+    return true;
+}
+#endif
+
+static void usage(const char *name) {
+    #ifdef USE_SHM
+    fprintf(stderr, "Usage: %s [--format=text|json|binary] [--flush-us=T] [--flush-bytes=N] [--shm=NAME]\n", name);
+    #elif defined(__linux__)
+    fprintf(stderr, "Usage: %s [--format=text|json|binary] [--flush-us=T] [--flush-bytes=N]\n", name);
+    #else
+    fprintf(stderr, "Usage: %s [--format=text|json|binary]\n", name);
+    #endif
+    fprintf(stderr, "  --format=text    one JavaScript object literal per line (default)\n");
+    fprintf(stderr, "  --format=json    one JSON object per line, including typed characters\n");
+    fprintf(stderr, "  --format=binary  fixed size little-endian records, see BINARY_MAGIC\n");
+    #ifdef __linux__
+    fprintf(stderr, "  --flush-us=T     buffer output on a writer thread for at most T microseconds\n");
+    fprintf(stderr, "  --flush-bytes=N  write buffered output once N bytes are pending (default: %zu)\n", flush_bytes);
+    #endif
+    #ifdef USE_SHM
+    fprintf(stderr, "  --shm=NAME       write records to the shared memory ring NAME instead of stdout\n");
+    #endif
+}
+
+int main(int argc, char *argv[]) {
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--format=text") == 0) {
+            format = FORMAT_TEXT;
+            continue;
+        } else if (strcmp(argv[i], "--format=json") == 0) {
+            format = FORMAT_JSON;
+            continue;
+        } else if (strcmp(argv[i], "--format=binary") == 0) {
+            format = FORMAT_BINARY;
+            continue;
+        }
+
+        #ifdef __linux__
+        if (strncmp(argv[i], "--flush-us=", 11) == 0) {
+            flush_us = strtoul(argv[i] + 11, NULL, 10);
+            continue;
+        } else if (strncmp(argv[i], "--flush-bytes=", 14) == 0) {
+            flush_bytes = (size_t) strtoul(argv[i] + 14, NULL, 10);
+            if (flush_bytes > 0) {
+                continue;
+            }
+        }
+        #endif
+
+        #ifdef USE_SHM
+        if (strncmp(argv[i], "--shm=", 6) == 0) {
+            if (!open_shm(argv[i] + 6)) {
+                return EXIT_FAILURE;
+            }
+            continue;
+        }
+        #endif
+
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    if (format == FORMAT_BINARY) {
+        #ifdef _WIN32
+        _setmode(_fileno(stdout), _O_BINARY);
+        #endif
+        write_binary_header();
+    }
+
     // Set the logger callback for library output.
     hook_set_logger_proc(&logger_proc);
     
@@ -170,7 +693,15 @@ int main() {
 
     // Start the hook and block.
     // NOTE If EVENT_HOOK_ENABLED was delivered, the status will always succeed.
+    #ifdef __linux__
+    #ifdef USE_SHM
+    int status = flush_us > 0 && shm == NULL ? run_writer() : hook_run();
+    #else
+    int status = flush_us > 0 ? run_writer() : hook_run();
+    #endif
+    #else
     int status = hook_run();
+    #endif
     switch (status) {
         case UIOHOOK_SUCCESS:
             // Everything is ok.
@@ -238,5 +769,9 @@ int main() {
             break;
     }
 
+    #ifdef USE_SHM
+    uiohook_shm_destroy(shm);
+    #endif
+
     return status;
 }
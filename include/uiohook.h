@@ -21,6 +21,7 @@
 
 #include <stdarg.h>
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 
 /* Begin Error Codes */
@@ -29,6 +30,7 @@
 
 // System level errors.
 #define UIOHOOK_ERROR_OUT_OF_MEMORY              0x02
+#define UIOHOOK_ERROR_CREATE_THREAD              0x03
 
 // Unix specific errors.
 #define UIOHOOK_ERROR_X_OPEN_DISPLAY             0x20
@@ -77,6 +79,10 @@ typedef enum _event_type {
     EVENT_MOUSE_WHEEL
 } event_type;
 
+// Bit for an event type in hook_set_event_mask().
+#define EVENT_TYPE_MASK(type)                    (1U << (type))
+#define EVENT_MASK_ALL                           0xFFFFFFFFU
+
 typedef struct _screen_data {
     uint8_t number;
     int16_t x;
@@ -127,6 +133,39 @@ typedef struct _uiohook_event {
 } uiohook_event;
 
 typedef void (*dispatcher_t)(uiohook_event *const);
+
+// Flags for hook_post_events().
+#define POST_EVENTS_ASYNC                        0x01
+
+// Buffer size that fits any event encoded by hook_event_to_json().
+#define UIOHOOK_JSON_MAX_SIZE                    256
+
+// What hook_run_async() does when its event queue is full.
+typedef enum _queue_overflow {
+    QUEUE_OVERFLOW_DROP = 0,
+    QUEUE_OVERFLOW_BLOCK
+} queue_overflow;
+
+typedef struct _dispatch_stats {
+    uint64_t enqueued;
+    uint64_t dropped;
+} dispatch_stats;
+
+// Timing of a hook_replay() run, lateness is from each deadline until its post returned.
+typedef struct _replay_stats {
+    uint64_t posted;
+    uint64_t skipped;
+    uint64_t failed;
+    uint64_t duration_ns;
+    uint64_t late_mean_ns;
+    uint64_t late_p50_ns;
+    uint64_t late_p99_ns;
+    uint64_t late_max_ns;
+    uint64_t late_over_1ms;
+} replay_stats;
+
+// Supplies the next event to hook_replay(), returns false at the end of the stream.
+typedef bool (*replay_source_t)(uiohook_event *event, void *arg);
 /* End Virtual Event Types and Data Structures */
 
 
@@ -417,15 +456,55 @@ extern "C" {
     // Set the logger callback functions.
     UIOHOOK_API void hook_set_logger_proc(logger_t logger_proc);
 
+    // Set the lowest log level passed to the logger callback.
+    UIOHOOK_API void hook_set_logger_level(unsigned int level);
+
+    // Encode an event as a null terminated JSON object, returns its length or 0 if it did not fit.
+    UIOHOOK_API size_t hook_event_to_json(const uiohook_event * const event, char *buffer, size_t size);
+
     // Send a virtual event back to the system.
     UIOHOOK_API void hook_post_event(uiohook_event * const event);
 
+    #if !defined(__APPLE__) && !defined(__MACH__) && !defined(_WIN32)
+    // Send count virtual events with a single server round trip, or none with POST_EVENTS_ASYNC (X11 only).
+    UIOHOOK_API size_t hook_post_events(const uiohook_event *events, size_t count, unsigned int flags);
+
+    // Type a UTF-8 string with XTest, returns the number of characters posted (X11 only).
+    UIOHOOK_API size_t hook_post_text(const char *utf8);
+
+    // Post events from source at their recorded times scaled by 1 / speed (X11 only).
+    UIOHOOK_API int hook_replay(replay_source_t source, void *arg, double speed, replay_stats *stats);
+
+    // Post an array of events at their recorded times scaled by 1 / speed (X11 only).
+    UIOHOOK_API int hook_replay_events(const uiohook_event *events, size_t count, double speed, replay_stats *stats);
+    #endif
+
     // Set the event callback function.
     UIOHOOK_API void hook_set_dispatch_proc(dispatcher_t dispatch_proc);
 
     // Insert the event hook.
     UIOHOOK_API int hook_run();
 
+    #if !defined(__APPLE__) && !defined(__MACH__) && !defined(_WIN32)
+    // Insert the event hook and call the dispatcher from a library thread (X11 only).
+    UIOHOOK_API int hook_run_async(size_t capacity, queue_overflow overflow);
+
+    // Retrieves the hook_run_async() or event descriptor queue counters (X11 only).
+    UIOHOOK_API void hook_get_dispatch_stats(dispatch_stats *stats);
+
+    // Queue events for hook_read_events() and return an eventfd that is readable while events are queued (X11 on Linux only).
+    UIOHOOK_API int hook_open_event_fd(size_t capacity, queue_overflow overflow);
+
+    // Copy up to max queued events into buffer without blocking, returns the number copied (X11 only).
+    UIOHOOK_API size_t hook_read_events(uiohook_event *buffer, size_t max);
+
+    // Close the descriptor from hook_open_event_fd(), fails while the hook is running (X11 only).
+    UIOHOOK_API int hook_close_event_fd();
+
+    // Select the event types sent to the dispatcher, also while running (X11 only).
+    UIOHOOK_API int hook_set_event_mask(uint32_t mask);
+    #endif
+
     // Withdraw the event hook.
     UIOHOOK_API int hook_stop();
 
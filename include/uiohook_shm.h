@@ -0,0 +1,93 @@
+/* libUIOHook: Cross-platform keyboard and mouse hooking from userland.
+ * Copyright (C) 2006-2023 Alexander Barker.  All Rights Reserved.
+ * https://github.com/kwhat/libuiohook/
+ *
+ * libUIOHook is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libUIOHook is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __UIOHOOK_SHM_H
+#define __UIOHOOK_SHM_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <uiohook.h>
+
+/* Begin Shared Memory Ring Layout */
+#define UIOHOOK_SHM_MAGIC                        0x4B484955U
+#define UIOHOOK_SHM_VERSION                      1
+
+/* Fixed size event record stored in the ring, 32 bytes in host byte order.
+ * The data union has the same layout as the one in uiohook_event.
+ */
+typedef struct _uiohook_shm_record {
+    uint8_t type;
+    uint8_t reserved;
+    uint16_t mask;
+    uint32_t padding;
+    uint64_t time;
+    union {
+        keyboard_event_data keyboard;
+        mouse_event_data mouse;
+        mouse_wheel_event_data wheel;
+    } data;
+} uiohook_shm_record;
+
+// Either end of a shared memory ring.
+typedef struct _uiohook_shm uiohook_shm;
+/* End Shared Memory Ring Layout */
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+    // Copy an event into a ring record.
+    UIOHOOK_API void uiohook_shm_pack(const uiohook_event *event, uiohook_shm_record *record);
+
+    // Create the named ring for at least capacity records and become its only writer.
+    UIOHOOK_API uiohook_shm * uiohook_shm_create(const char *name, size_t capacity);
+
+    // Append an event without blocking, returns false and counts it as dropped if the ring is full.
+    UIOHOOK_API bool uiohook_shm_write(uiohook_shm *shm, const uiohook_event *event);
+
+    // Mark the ring closed, unmap it and remove its name.
+    UIOHOOK_API void uiohook_shm_destroy(uiohook_shm *shm);
+
+    // Map an existing named ring and become its only reader.
+    UIOHOOK_API uiohook_shm * uiohook_shm_open(const char *name);
+
+    // Point records at the oldest unread records in place, returns how many are contiguous.
+    UIOHOOK_API size_t uiohook_shm_peek(uiohook_shm *shm, const uiohook_shm_record **records);
+
+    // Return count records obtained from uiohook_shm_peek() to the writer.
+    UIOHOOK_API void uiohook_shm_release(uiohook_shm *shm, size_t count);
+
+    // Wait up to timeout_ms, or forever if negative, for unread records.  Returns false on timeout or close.
+    UIOHOOK_API bool uiohook_shm_wait(uiohook_shm *shm, int timeout_ms);
+
+    // Returns the number of events the writer could not fit in the ring.
+    UIOHOOK_API uint64_t uiohook_shm_dropped(uiohook_shm *shm);
+
+    // Returns true once the writer has destroyed the ring.
+    UIOHOOK_API bool uiohook_shm_closed(uiohook_shm *shm);
+
+    // Unmap a ring opened with uiohook_shm_open().
+    UIOHOOK_API void uiohook_shm_close(uiohook_shm *shm);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
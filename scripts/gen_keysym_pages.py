@@ -0,0 +1,132 @@
+#!/usr/bin/env python3
+# libUIOHook: Cross-platform keyboard and mouse hooking from userland.
+# Copyright (C) 2006-2023 Alexander Barker.  All Rights Reserved.
+# https://github.com/kwhat/libuiohook/
+#
+# libUIOHook is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License as published
+# by the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# libUIOHook is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+"""Regenerate the keysym page tables in src/x11/input_helper.c.
+
+The two level page tables used by keysym_to_unicode() and unicode_to_keysym()
+are built from keysym_unicode_table[] in the same file and replace everything
+between the generated block markers.  Run after changing keysym_unicode_table[]:
+
+    scripts/gen_keysym_pages.py [src/x11/input_helper.c]
+
+With --check the file is left alone and the exit status is 1 if the tables are
+out of date.
+"""
+
+import os
+import re
+import sys
+
+BEGIN = "/* Begin generated keysym pages, see scripts/gen_keysym_pages.py. */\n"
+END = "/* End generated keysym pages. */\n"
+
+
+def parse_table(source):
+    start = source.index("} keysym_unicode_table[] = {")
+    end = source.index("};", start)
+    return [(int(keysym, 16), int(unicode, 16)) for keysym, unicode
+            in re.findall(r"\{\s*(0x[0-9A-Fa-f]+),\s*(0x[0-9A-Fa-f]+)\s*\}", source[start:end])]
+
+
+def build_pages(mapping):
+    count = max(mapping) // 256 + 1
+    pages, index = [], []
+    for page in range(count):
+        values = [mapping.get(page * 256 + low, 0) for low in range(256)]
+        if any(values):
+            pages.append((page, values))
+            index.append(len(pages))
+        else:
+            index.append(0)
+
+    return count, index, pages
+
+
+def format_pages(prefix, count_name, count, index, pages):
+    lines = ["#define %s %d\n" % (count_name, count), "\n",
+             "static const uint8_t %s_page_index[%s] = {\n" % (prefix, count_name)]
+    for i in range(0, len(index), 8):
+        lines.append("    " + ", ".join("%2d" % value for value in index[i:i + 8]) + ",\n")
+    lines += ["};\n", "\n", "static const uint16_t %s_pages[][256] = {\n" % prefix,
+              "    /* empty */ { 0 },\n"]
+    for page, values in pages:
+        lines.append("    /* 0x%04X */ {\n" % (page * 256))
+        for i in range(0, 256, 8):
+            lines.append("        " + ", ".join("0x%04X" % value for value in values[i:i + 8]) + ",\n")
+        lines.append("    },\n")
+    lines.append("};\n")
+
+    return "".join(lines)
+
+
+def generate(table):
+    keysym_unicode = {}
+    unicode_keysym = {}
+    for keysym, unicode in table:
+        keysym_unicode.setdefault(keysym, unicode)
+        # Where several keysyms produce the same character the lowest is used.
+        if unicode not in unicode_keysym or keysym < unicode_keysym[unicode]:
+            unicode_keysym[unicode] = keysym
+
+    for keysym, unicode in unicode_keysym.items():
+        if keysym > 0xFFFF:
+            sys.exit("keysym 0x%X does not fit the uint16_t pages" % keysym)
+
+    return (BEGIN
+            + "/* Two level page table with the same contents as keysym_unicode_table[],\n"
+            " * indexed by the high and low byte of the keysym, so keysym_to_unicode() can\n"
+            " * look up any keysym with two loads.  Unmapped keysyms hold 0.  Page 0 is\n"
+            " * empty and shared by every keysym page without entries.  input_helper_test\n"
+            " * checks that the tables agree with keysym_unicode_table[].\n"
+            " */\n"
+            + format_pages("keysym_unicode", "KEYSYM_UNICODE_PAGES", *build_pages(keysym_unicode))
+            + "\n"
+            "/* Two level page table mapping Unicode characters back to the keysyms in\n"
+            " * keysym_unicode_table[], indexed by the high and low byte of the character.\n"
+            " * Where several keysyms produce the same character the lowest keysym is used.\n"
+            " * Unmapped characters hold 0 and page 0 is shared by every empty page, as for\n"
+            " * keysym_unicode_pages[].\n"
+            " */\n"
+            + format_pages("unicode_keysym", "UNICODE_KEYSYM_PAGES", *build_pages(unicode_keysym))
+            + END)
+
+
+def main(argv):
+    check = "--check" in argv
+    paths = [arg for arg in argv if arg != "--check"]
+    path = paths[0] if paths else os.path.join(os.path.dirname(__file__), "..", "src", "x11", "input_helper.c")
+
+    with open(path) as file:
+        source = file.read()
+
+    start = source.index(BEGIN)
+    end = source.index(END, start) + len(END)
+    updated = source[:start] + generate(parse_table(source)) + source[end:]
+
+    if check:
+        return 0 if updated == source else 1
+
+    if updated != source:
+        with open(path, "w") as file:
+            file.write(updated)
+
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv[1:]))
@@ -0,0 +1,198 @@
+/* libUIOHook: Cross-platform keyboard and mouse hooking from userland.
+ * Copyright (C) 2006-2023 Alexander Barker.  All Rights Reserved.
+ * https://github.com/kwhat/libuiohook/
+ *
+ * libUIOHook is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libUIOHook is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <uiohook.h>
+
+// Output cursor, end is reserved for the terminating null.
+typedef struct _json_writer {
+    char *pos;
+    char *end;
+} json_writer;
+
+static const char hex_digits[] = "0123456789abcdef";
+
+static const char * const event_names[] = {
+    [EVENT_HOOK_ENABLED]   = "HOOK_ENABLED",
+    [EVENT_HOOK_DISABLED]  = "HOOK_DISABLED",
+    [EVENT_KEY_TYPED]      = "KEY_TYPED",
+    [EVENT_KEY_PRESSED]    = "KEY_PRESSED",
+    [EVENT_KEY_RELEASED]   = "KEY_RELEASED",
+    [EVENT_MOUSE_CLICKED]  = "MOUSE_CLICKED",
+    [EVENT_MOUSE_PRESSED]  = "MOUSE_PRESSED",
+    [EVENT_MOUSE_RELEASED] = "MOUSE_RELEASED",
+    [EVENT_MOUSE_MOVED]    = "MOUSE_MOVED",
+    [EVENT_MOUSE_DRAGGED]  = "MOUSE_DRAGGED",
+    [EVENT_MOUSE_WHEEL]    = "MOUSE_WHEEL"
+};
+
+static inline bool put_bytes(json_writer *out, const char *bytes, size_t length) {
+    if ((size_t) (out->end - out->pos) < length) {
+        return false;
+    }
+
+    memcpy(out->pos, bytes, length);
+    out->pos += length;
+
+    return true;
+}
+
+// Write a string literal, the length is known at compile time.
+#define put_literal(out, literal) put_bytes(out, literal, sizeof(literal) - 1)
+
+static inline bool put_uint(json_writer *out, uint64_t value) {
+    // Digits are produced backwards into a scratch buffer.
+    char digits[20];
+    char *first = digits + sizeof(digits);
+    do {
+        *--first = (char) ('0' + value % 10);
+        value /= 10;
+    } while (value > 0);
+
+    return put_bytes(out, first, (size_t) (digits + sizeof(digits) - first));
+}
+
+static inline bool put_int(json_writer *out, int32_t value) {
+    if (value < 0) {
+        return put_literal(out, "-") && put_uint(out, (uint64_t) -(int64_t) value);
+    }
+
+    return put_uint(out, (uint64_t) value);
+}
+
+// Write a field name and its leading separator, the first field is "id".
+#define put_field(out, name) put_literal(out, ",\"" name "\":")
+
+static bool put_escape(json_writer *out, uint16_t unit) {
+    char escape[6] = { '\\', 'u',
+        hex_digits[(unit >> 12) & 0x0F], hex_digits[(unit >> 8) & 0x0F],
+        hex_digits[(unit >> 4) & 0x0F], hex_digits[unit & 0x0F] };
+
+    return put_bytes(out, escape, sizeof(escape));
+}
+
+/* Write a single UTF-16 code unit as a JSON string.  Surrogates can not be
+ * encoded as UTF-8 on their own, so they are escaped and a consumer that
+ * concatenates consecutive KEY_TYPED characters gets the original pair back.
+ */
+static bool put_keychar(json_writer *out, uint16_t unit) {
+    if (!put_literal(out, "\"")) {
+        return false;
+    }
+
+    bool status;
+    switch (unit) {
+        case '"':  status = put_literal(out, "\\\""); break;
+        case '\\': status = put_literal(out, "\\\\"); break;
+        case '\b': status = put_literal(out, "\\b"); break;
+        case '\f': status = put_literal(out, "\\f"); break;
+        case '\n': status = put_literal(out, "\\n"); break;
+        case '\r': status = put_literal(out, "\\r"); break;
+        case '\t': status = put_literal(out, "\\t"); break;
+
+        default:
+            if (unit < 0x20 || (unit >= 0xD800 && unit <= 0xDFFF)) {
+                status = put_escape(out, unit);
+            } else if (unit < 0x80) {
+                char utf8 = (char) unit;
+                status = put_bytes(out, &utf8, 1);
+            } else if (unit < 0x800) {
+                char utf8[2] = { (char) (0xC0 | (unit >> 6)), (char) (0x80 | (unit & 0x3F)) };
+                status = put_bytes(out, utf8, sizeof(utf8));
+            } else {
+                char utf8[3] = { (char) (0xE0 | (unit >> 12)), (char) (0x80 | ((unit >> 6) & 0x3F)),
+                        (char) (0x80 | (unit & 0x3F)) };
+                status = put_bytes(out, utf8, sizeof(utf8));
+            }
+            break;
+    }
+
+    return status && put_literal(out, "\"");
+}
+
+static bool put_event(json_writer *out, const uiohook_event * const event) {
+    bool status = put_literal(out, "{\"id\":") && put_uint(out, event->type)
+            && put_field(out, "when") && put_uint(out, event->time)
+            && put_field(out, "mask") && put_uint(out, event->mask);
+
+    switch (event->type) {
+        case EVENT_KEY_TYPED:
+            status = status
+                    && put_field(out, "keychar") && put_keychar(out, event->data.keyboard.keychar)
+                    && put_field(out, "rawcode") && put_uint(out, event->data.keyboard.rawcode);
+            break;
+
+        case EVENT_KEY_PRESSED:
+        case EVENT_KEY_RELEASED:
+            status = status
+                    && put_field(out, "keycode") && put_uint(out, event->data.keyboard.keycode)
+                    && put_field(out, "rawcode") && put_uint(out, event->data.keyboard.rawcode);
+            break;
+
+        case EVENT_MOUSE_CLICKED:
+        case EVENT_MOUSE_PRESSED:
+        case EVENT_MOUSE_RELEASED:
+        case EVENT_MOUSE_MOVED:
+        case EVENT_MOUSE_DRAGGED:
+            status = status
+                    && put_field(out, "x") && put_int(out, event->data.mouse.x)
+                    && put_field(out, "y") && put_int(out, event->data.mouse.y)
+                    && put_field(out, "button") && put_uint(out, event->data.mouse.button)
+                    && put_field(out, "clicks") && put_uint(out, event->data.mouse.clicks);
+            break;
+
+        case EVENT_MOUSE_WHEEL:
+            status = status
+                    && put_field(out, "x") && put_int(out, event->data.wheel.x)
+                    && put_field(out, "y") && put_int(out, event->data.wheel.y)
+                    && put_field(out, "clicks") && put_uint(out, event->data.wheel.clicks)
+                    && put_field(out, "type") && put_uint(out, event->data.wheel.type)
+                    && put_field(out, "amount") && put_uint(out, event->data.wheel.amount)
+                    && put_field(out, "rotation") && put_int(out, event->data.wheel.rotation)
+                    && put_field(out, "direction") && put_uint(out, event->data.wheel.direction);
+            break;
+
+        default:
+            break;
+    }
+
+    if (status && event->type >= EVENT_HOOK_ENABLED && event->type <= EVENT_MOUSE_WHEEL) {
+        const char *name = event_names[event->type];
+        status = put_literal(out, ",\"event\":\"") && put_bytes(out, name, strlen(name)) && put_literal(out, "\"");
+    }
+
+    return status && put_literal(out, "}");
+}
+
+UIOHOOK_API size_t hook_event_to_json(const uiohook_event * const event, char *buffer, size_t size) {
+    if (buffer == NULL || size == 0) {
+        return 0;
+    }
+
+    json_writer out = { buffer, buffer + size - 1 };
+    if (!put_event(&out, event)) {
+        buffer[0] = '\0';
+        return 0;
+    }
+    *out.pos = '\0';
+
+    return (size_t) (out.pos - buffer);
+}
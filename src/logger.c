@@ -16,6 +16,7 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <limits.h>
 #include <stdarg.h>
 #include <stdbool.h>
 #include <stdint.h>
@@ -29,12 +30,28 @@ static bool default_logger(unsigned int level, const char *format, ...) {
 }
 
 // Current logger function pointer, should never be null.
-logger_t logger = &default_logger;
+logger_t uiohook_logger = &default_logger;
 
-UIOHOOK_API void hook_set_logger_proc(logger_t logger_proc) {
-    if (logger_proc == NULL) {
-        logger = &default_logger;
+// Level requested with hook_set_logger_level().
+static unsigned int requested_level = LOG_LEVEL_DEBUG;
+
+// Effective level, nothing passes while the default logger is installed.
+unsigned int uiohook_log_level = UINT_MAX;
+
+UIOHOOK_API void hook_set_logger_proc(logger_t proc) {
+    if (proc == NULL) {
+        uiohook_logger = &default_logger;
+        uiohook_log_level = UINT_MAX;
     } else {
-        logger = logger_proc;
+        uiohook_logger = proc;
+        uiohook_log_level = requested_level;
+    }
+}
+
+UIOHOOK_API void hook_set_logger_level(unsigned int level) {
+    requested_level = level;
+
+    if (uiohook_logger != &default_logger) {
+        uiohook_log_level = level;
     }
 }
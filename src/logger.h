@@ -26,7 +26,26 @@
 #define __FUNCTION__ __func__
 #endif
 
-// logger(level, message)
-extern logger_t logger;
+// Lowest level compiled into the library, messages below it are removed.
+#ifndef UIOHOOK_LOG_MIN_LEVEL
+#define UIOHOOK_LOG_MIN_LEVEL LOG_LEVEL_DEBUG
+#endif
+
+// Current logger function pointer, should never be null.
+extern logger_t uiohook_logger;
+
+// Lowest level passed to uiohook_logger at runtime.
+extern unsigned int uiohook_log_level;
+
+/* logger(level, message)
+ * Both level checks happen before any of the arguments are evaluated, and the
+ * compile time check allows the whole call to be optimized out.
+ */
+#define logger(level, ...) \
+    do { \
+        if ((level) >= UIOHOOK_LOG_MIN_LEVEL && (level) >= uiohook_log_level) { \
+            uiohook_logger((level), __VA_ARGS__); \
+        } \
+    } while (0)
 
 #endif
@@ -0,0 +1,307 @@
+/* libUIOHook: Cross-platform keyboard and mouse hooking from userland.
+ * Copyright (C) 2006-2023 Alexander Barker.  All Rights Reserved.
+ * https://github.com/kwhat/libuiohook/
+ *
+ * libUIOHook is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libUIOHook is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <uiohook.h>
+#include <uiohook_shm.h>
+#include <unistd.h>
+
+#define CACHE_LINE_SIZE 64
+
+/* Shared header at the start of the mapping, followed by the records.  Each
+ * side only writes its own cache line.  The head and tail indices only ever
+ * increase.  The reader sets waiting before it sleeps on the doorbell futex,
+ * so the writer only makes a system call when someone is actually asleep.
+ */
+typedef struct _shm_header {
+    // Written once by the writer before the name is visible.
+    uint32_t magic;
+    uint16_t version;
+    uint16_t record_size;
+    uint32_t capacity;
+    char info_pad[CACHE_LINE_SIZE - 12];
+
+    // Written by the writer.
+    uint64_t head;
+    uint64_t dropped;
+    uint32_t doorbell;
+    uint32_t closed;
+    char head_pad[CACHE_LINE_SIZE - 24];
+
+    // Written by the reader.
+    uint64_t tail;
+    uint32_t waiting;
+    char tail_pad[CACHE_LINE_SIZE - 12];
+} shm_header;
+
+struct _uiohook_shm {
+    shm_header *header;
+    uiohook_shm_record *records;
+    size_t size;
+    uint64_t mask;
+    char *name;
+};
+
+static long futex(uint32_t *address, int op, uint32_t value, const struct timespec *timeout) {
+    // Not FUTEX_PRIVATE_FLAG, the word is shared with another process.
+    return syscall(SYS_futex, address, op, value, timeout, NULL, 0);
+}
+
+// Map a ring of size bytes from fd and fill in shm.
+static uiohook_shm * map_ring(int fd, size_t size, const char *name, int prot) {
+    uiohook_shm *shm = malloc(sizeof(uiohook_shm));
+    if (shm == NULL) {
+        return NULL;
+    }
+
+    shm->name = strdup(name);
+    void *address = mmap(NULL, size, prot, MAP_SHARED, fd, 0);
+    if (shm->name == NULL || address == MAP_FAILED) {
+        free(shm->name);
+        free(shm);
+        return NULL;
+    }
+
+    shm->header = (shm_header *) address;
+    shm->records = (uiohook_shm_record *) ((char *) address + sizeof(shm_header));
+    shm->size = size;
+
+    return shm;
+}
+
+static void unmap_ring(uiohook_shm *shm) {
+    munmap(shm->header, shm->size);
+    free(shm->name);
+    free(shm);
+}
+
+UIOHOOK_API void uiohook_shm_pack(const uiohook_event *event, uiohook_shm_record *record) {
+    record->type = (uint8_t) event->type;
+    record->reserved = 0;
+    record->mask = event->mask;
+    record->padding = 0;
+    record->time = event->time;
+    memcpy(&record->data, &event->data, sizeof(record->data));
+}
+
+UIOHOOK_API uiohook_shm * uiohook_shm_create(const char *name, size_t capacity) {
+    if (capacity == 0 || capacity > UINT32_MAX / 2 + 1) {
+        errno = EINVAL;
+        return NULL;
+    }
+
+    uint32_t count = 1;
+    while (count < capacity) {
+        count <<= 1;
+    }
+
+    int fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (fd < 0) {
+        return NULL;
+    }
+
+    size_t size = sizeof(shm_header) + sizeof(uiohook_shm_record) * count;
+    uiohook_shm *shm = NULL;
+    if (ftruncate(fd, (off_t) size) == 0) {
+        shm = map_ring(fd, size, name, PROT_READ | PROT_WRITE);
+    }
+
+    int error = errno;
+    close(fd);
+
+    if (shm == NULL) {
+        shm_unlink(name);
+        errno = error;
+        return NULL;
+    }
+
+    // The new object is zero filled, only the fixed fields need to be set.
+    shm->mask = count - 1;
+    shm->header->version = UIOHOOK_SHM_VERSION;
+    shm->header->record_size = sizeof(uiohook_shm_record);
+    shm->header->capacity = count;
+    __atomic_store_n(&shm->header->magic, UIOHOOK_SHM_MAGIC, __ATOMIC_RELEASE);
+
+    return shm;
+}
+
+UIOHOOK_API bool uiohook_shm_write(uiohook_shm *shm, const uiohook_event *event) {
+    shm_header *header = shm->header;
+
+    uint64_t head = __atomic_load_n(&header->head, __ATOMIC_RELAXED);
+    if (head - __atomic_load_n(&header->tail, __ATOMIC_ACQUIRE) > shm->mask) {
+        __atomic_store_n(&header->dropped, header->dropped + 1, __ATOMIC_RELAXED);
+        return false;
+    }
+
+    uiohook_shm_pack(event, &shm->records[head & shm->mask]);
+    __atomic_store_n(&header->head, head + 1, __ATOMIC_SEQ_CST);
+
+    // Pairs with the waiting store and head check in uiohook_shm_wait().
+    if (__atomic_load_n(&header->waiting, __ATOMIC_SEQ_CST)) {
+        __atomic_add_fetch(&header->doorbell, 1, __ATOMIC_SEQ_CST);
+        futex(&header->doorbell, FUTEX_WAKE, 1, NULL);
+    }
+
+    return true;
+}
+
+UIOHOOK_API void uiohook_shm_destroy(uiohook_shm *shm) {
+    if (shm != NULL) {
+        __atomic_store_n(&shm->header->closed, 1, __ATOMIC_SEQ_CST);
+        __atomic_add_fetch(&shm->header->doorbell, 1, __ATOMIC_SEQ_CST);
+        futex(&shm->header->doorbell, FUTEX_WAKE, 1, NULL);
+
+        shm_unlink(shm->name);
+        unmap_ring(shm);
+    }
+}
+
+UIOHOOK_API uiohook_shm * uiohook_shm_open(const char *name) {
+    int fd = shm_open(name, O_RDWR, 0);
+    if (fd < 0) {
+        return NULL;
+    }
+
+    struct stat info;
+    uiohook_shm *shm = NULL;
+    if (fstat(fd, &info) == 0 && (size_t) info.st_size >= sizeof(shm_header)) {
+        shm = map_ring(fd, (size_t) info.st_size, name, PROT_READ | PROT_WRITE);
+    }
+
+    int error = errno;
+    close(fd);
+
+    if (shm == NULL) {
+        errno = error;
+        return NULL;
+    }
+
+    shm_header *header = shm->header;
+    if (__atomic_load_n(&header->magic, __ATOMIC_ACQUIRE) != UIOHOOK_SHM_MAGIC
+            || header->version != UIOHOOK_SHM_VERSION
+            || header->record_size != sizeof(uiohook_shm_record)
+            || header->capacity == 0 || (header->capacity & (header->capacity - 1)) != 0
+            || shm->size < sizeof(shm_header) + sizeof(uiohook_shm_record) * header->capacity) {
+        unmap_ring(shm);
+        errno = EPROTO;
+        return NULL;
+    }
+    shm->mask = header->capacity - 1;
+
+    return shm;
+}
+
+UIOHOOK_API size_t uiohook_shm_peek(uiohook_shm *shm, const uiohook_shm_record **records) {
+    uint64_t tail = __atomic_load_n(&shm->header->tail, __ATOMIC_RELAXED);
+    uint64_t available = __atomic_load_n(&shm->header->head, __ATOMIC_ACQUIRE) - tail;
+
+    // Stop at the end of the mapping, the rest is returned by the next peek.
+    uint64_t contiguous = shm->mask + 1 - (tail & shm->mask);
+    if (available > contiguous) {
+        available = contiguous;
+    }
+
+    *records = &shm->records[tail & shm->mask];
+
+    return (size_t) available;
+}
+
+UIOHOOK_API void uiohook_shm_release(uiohook_shm *shm, size_t count) {
+    uint64_t tail = __atomic_load_n(&shm->header->tail, __ATOMIC_RELAXED);
+    __atomic_store_n(&shm->header->tail, tail + count, __ATOMIC_RELEASE);
+}
+
+UIOHOOK_API bool uiohook_shm_wait(uiohook_shm *shm, int timeout_ms) {
+    shm_header *header = shm->header;
+    uint64_t tail = __atomic_load_n(&header->tail, __ATOMIC_RELAXED);
+
+    // Signals and wakeups without new records restart the wait, so it is
+    // bounded by a deadline rather than by each futex call.
+    struct timespec deadline, timeout, *delay = NULL;
+    if (timeout_ms >= 0) {
+        clock_gettime(CLOCK_MONOTONIC, &deadline);
+        deadline.tv_sec += timeout_ms / 1000;
+        deadline.tv_nsec += (long) (timeout_ms % 1000) * 1000000;
+        if (deadline.tv_nsec >= 1000000000) {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000;
+        }
+        delay = &timeout;
+    }
+
+    while (true) {
+        uint32_t doorbell = __atomic_load_n(&header->doorbell, __ATOMIC_SEQ_CST);
+
+        __atomic_store_n(&header->waiting, 1, __ATOMIC_SEQ_CST);
+        bool ready = __atomic_load_n(&header->head, __ATOMIC_SEQ_CST) != tail;
+        bool closed = __atomic_load_n(&header->closed, __ATOMIC_SEQ_CST) != 0;
+        if (ready || closed) {
+            __atomic_store_n(&header->waiting, 0, __ATOMIC_RELAXED);
+            return ready;
+        }
+
+        if (delay != NULL) {
+            struct timespec now;
+            clock_gettime(CLOCK_MONOTONIC, &now);
+            timeout.tv_sec = deadline.tv_sec - now.tv_sec;
+            timeout.tv_nsec = deadline.tv_nsec - now.tv_nsec;
+            if (timeout.tv_nsec < 0) {
+                timeout.tv_sec--;
+                timeout.tv_nsec += 1000000000;
+            }
+
+            if (timeout.tv_sec < 0) {
+                __atomic_store_n(&header->waiting, 0, __ATOMIC_RELAXED);
+                return false;
+            }
+        }
+
+        // Returns straight away if the writer rang the doorbell since it was read.
+        long status = futex(&header->doorbell, FUTEX_WAIT, doorbell, delay);
+        __atomic_store_n(&header->waiting, 0, __ATOMIC_RELAXED);
+
+        if (status != 0 && errno == ETIMEDOUT) {
+            return __atomic_load_n(&header->head, __ATOMIC_ACQUIRE) != tail;
+        }
+    }
+}
+
+UIOHOOK_API uint64_t uiohook_shm_dropped(uiohook_shm *shm) {
+    return __atomic_load_n(&shm->header->dropped, __ATOMIC_RELAXED);
+}
+
+UIOHOOK_API bool uiohook_shm_closed(uiohook_shm *shm) {
+    return __atomic_load_n(&shm->header->closed, __ATOMIC_ACQUIRE) != 0;
+}
+
+UIOHOOK_API void uiohook_shm_close(uiohook_shm *shm) {
+    if (shm != NULL) {
+        unmap_ring(shm);
+    }
+}
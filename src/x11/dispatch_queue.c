@@ -0,0 +1,157 @@
+/* libUIOHook: Cross-platform keyboard and mouse hooking from userland.
+ * Copyright (C) 2006-2023 Alexander Barker.  All Rights Reserved.
+ * https://github.com/kwhat/libuiohook/
+ *
+ * libUIOHook is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libUIOHook is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <errno.h>
+#include <limits.h>
+#include <semaphore.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <uiohook.h>
+
+#include "dispatch_queue.h"
+#include "logger.h"
+
+#define CACHE_LINE_SIZE 64
+
+/* The head and tail indices only ever increase and are each written by a
+ * single thread, so they are kept on separate cache lines.  The semaphores
+ * count filled and free slots; they only enter the kernel when one side has
+ * to sleep.
+ */
+struct _dispatch_queue {
+    // Written by the producer.
+    size_t head;
+    char head_pad[CACHE_LINE_SIZE - sizeof(size_t)];
+
+    // Written by the consumer.
+    size_t tail;
+    char tail_pad[CACHE_LINE_SIZE - sizeof(size_t)];
+
+    size_t mask;
+    sem_t filled;
+    sem_t free;
+    uiohook_event *events;
+};
+
+dispatch_queue * create_dispatch_queue(size_t capacity) {
+    // The free slot count must fit in a semaphore and the ring in memory.
+    if (capacity == 0 || capacity > SEM_VALUE_MAX / 2 + 1
+            || capacity > SIZE_MAX / 2 / sizeof(uiohook_event)) {
+        logger(LOG_LEVEL_ERROR, "%s [%u]: Invalid queue capacity %zu!\n",
+                __FUNCTION__, __LINE__, capacity);
+
+        return NULL;
+    }
+
+    size_t size = 1;
+    while (size < capacity) {
+        size <<= 1;
+    }
+
+    dispatch_queue *queue = malloc(sizeof(dispatch_queue));
+    if (queue == NULL) {
+        logger(LOG_LEVEL_ERROR, "%s [%u]: Failed to allocate memory for dispatch queue!\n",
+                __FUNCTION__, __LINE__);
+
+        return NULL;
+    }
+
+    queue->events = malloc(sizeof(uiohook_event) * size);
+    if (queue->events == NULL) {
+        logger(LOG_LEVEL_ERROR, "%s [%u]: Failed to allocate memory for %zu queued events!\n",
+                __FUNCTION__, __LINE__, size);
+
+        free(queue);
+        return NULL;
+    }
+
+    queue->head = 0;
+    queue->tail = 0;
+    queue->mask = size - 1;
+    sem_init(&queue->filled, 0, 0);
+    sem_init(&queue->free, 0, (unsigned int) size);
+
+    logger(LOG_LEVEL_DEBUG, "%s [%u]: Created dispatch queue for %zu events.\n",
+            __FUNCTION__, __LINE__, size);
+
+    return queue;
+}
+
+void destroy_dispatch_queue(dispatch_queue *queue) {
+    if (queue != NULL) {
+        sem_destroy(&queue->filled);
+        sem_destroy(&queue->free);
+
+        free(queue->events);
+        free(queue);
+    }
+}
+
+size_t dispatch_queue_capacity(dispatch_queue *queue) {
+    return queue->mask + 1;
+}
+
+// Wait on a semaphore, retrying after signal interruptions.
+static bool wait_semaphore(sem_t *sem, bool block) {
+    int status;
+    if (block) {
+        while ((status = sem_wait(sem)) != 0 && errno == EINTR);
+    } else {
+        while ((status = sem_trywait(sem)) != 0 && errno == EINTR);
+    }
+
+    return status == 0;
+}
+
+bool dispatch_queue_push(dispatch_queue *queue, const uiohook_event *event, bool block) {
+    if (!wait_semaphore(&queue->free, block)) {
+        return false;
+    }
+
+    size_t head = __atomic_load_n(&queue->head, __ATOMIC_RELAXED);
+    queue->events[head & queue->mask] = *event;
+    __atomic_store_n(&queue->head, head + 1, __ATOMIC_RELEASE);
+
+    sem_post(&queue->filled);
+
+    return true;
+}
+
+bool dispatch_queue_pop(dispatch_queue *queue, uiohook_event *event, bool block) {
+    if (!wait_semaphore(&queue->filled, block)) {
+        return false;
+    }
+
+    size_t tail = __atomic_load_n(&queue->tail, __ATOMIC_RELAXED);
+    if (tail == __atomic_load_n(&queue->head, __ATOMIC_ACQUIRE)) {
+        // Woken by dispatch_queue_wake() with nothing queued.
+        return false;
+    }
+
+    *event = queue->events[tail & queue->mask];
+    __atomic_store_n(&queue->tail, tail + 1, __ATOMIC_RELEASE);
+
+    sem_post(&queue->free);
+
+    return true;
+}
+
+void dispatch_queue_wake(dispatch_queue *queue) {
+    sem_post(&queue->filled);
+}
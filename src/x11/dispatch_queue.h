@@ -0,0 +1,61 @@
+/* libUIOHook: Cross-platform keyboard and mouse hooking from userland.
+ * Copyright (C) 2006-2023 Alexander Barker.  All Rights Reserved.
+ * https://github.com/kwhat/libuiohook/
+ *
+ * libUIOHook is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libUIOHook is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _included_dispatch_queue
+#define _included_dispatch_queue
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <uiohook.h>
+
+// Single producer, single consumer ring of events.
+typedef struct _dispatch_queue dispatch_queue;
+
+/* Create a queue holding at least capacity events.  The capacity is rounded up
+ * to the next power of two.  Returns NULL if capacity is zero or memory could
+ * not be allocated.
+ */
+extern dispatch_queue * create_dispatch_queue(size_t capacity);
+
+/* Release a queue created by create_dispatch_queue().  Neither side may be
+ * using the queue.
+ */
+extern void destroy_dispatch_queue(dispatch_queue *queue);
+
+/* Returns the number of events the queue can hold.
+ */
+extern size_t dispatch_queue_capacity(dispatch_queue *queue);
+
+/* Copy an event into the queue.  Only one thread may push.  If the queue is
+ * full this waits for the consumer when block is true, otherwise it returns
+ * false without copying the event.
+ */
+extern bool dispatch_queue_push(dispatch_queue *queue, const uiohook_event *event, bool block);
+
+/* Copy the oldest event out of the queue.  Only one thread may pop.  If the
+ * queue is empty this waits for the producer when block is true, otherwise it
+ * returns false.  A blocking pop also returns false after
+ * dispatch_queue_wake().
+ */
+extern bool dispatch_queue_pop(dispatch_queue *queue, uiohook_event *event, bool block);
+
+/* Wake a consumer blocked in dispatch_queue_pop() without pushing an event.
+ */
+extern void dispatch_queue_wake(dispatch_queue *queue);
+
+#endif
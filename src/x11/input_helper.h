@@ -20,7 +20,10 @@
 #define _included_input_helper
 
 #include <stdint.h>
+#include <uiohook.h>
 #include <X11/Xlib.h>
+#include <X11/XKBlib.h>
+#include <X11/extensions/record.h>
 
 #ifdef USE_XKB_COMMON
 #include <X11/Xlib-xcb.h>
@@ -43,11 +46,118 @@
 // Helper display used by input helper, properties and post event.
 extern Display *helper_disp;
 
+/* Open helper_disp the first time it is needed.  Safe to call from any thread,
+ * only the first call contacts the X server.  helper_disp is still NULL
+ * afterwards if the display could not be opened.
+ */
+extern void load_helper_display();
+
+/* Open the helper display and start the settings thread that keeps the cached
+ * multi-click time, monitor layout, focus window and mappings current.  Only
+ * the first call does any work.  Called when the hook starts and by the API
+ * entry points whose data is followed by the thread in this build.
+ */
+extern void load_settings_thread();
+
+/* Returns the cached multi-click time without any initialization, for the hook
+ * after load_input_helper() and for hook_get_multi_click_time().
+ */
+extern long int get_multi_click_time();
+
+// Result of translating a key event with translate_key().
+typedef struct _key_translation {
+    KeySym keysym;
+    uint16_t scancode;
+    uint16_t unicode[2];
+    size_t count;
+} key_translation;
+
+// Immutable snapshot of the monitor layout.
+typedef struct _screen_layout {
+    uint8_t count;
+    screen_data screens[];
+} screen_layout;
+
+/* Returns the current monitor layout snapshot, or NULL if there is none,
+ * without blocking or contacting the X server.  The snapshot stays valid until
+ * it is handed back with put_screen_layout(), even if the settings thread
+ * replaces it in the meantime.
+ */
+extern const screen_layout * get_screen_layout(unsigned int *slot);
+
+/* Hand back a snapshot returned by get_screen_layout().
+ */
+extern void put_screen_layout(unsigned int slot);
+
+#ifndef USE_XTEST
+/* Returns the window with the input focus as last seen by the settings thread,
+ * which follows _NET_ACTIVE_WINDOW, FocusIn and FocusOut events on the root and
+ * the focus window, and top level windows being mapped or destroyed.  None if
+ * the focus window was found to be destroyed.  No request is made to the X
+ * server.
+ */
+extern Window get_focus_window();
+
+/* Returns a counter that changes whenever the focus window is updated, a top
+ * level window is reconfigured or a cached window turns out to be destroyed.
+ */
+extern unsigned long get_focus_generation();
+
+/* Returns the number of BadWindow errors caused by requests on helper_disp.
+ * These are handled so that sending to a destroyed window does not exit.
+ */
+extern unsigned long get_window_errors();
+#endif
+
+// Signature of hook_post_events(), which hook_replay() posts with by default.
+typedef size_t (*replay_sink_t)(const uiohook_event *events, size_t count, unsigned int flags);
+
+#ifdef USE_SYNTHETIC_HOOK
+/* Returns the number of times the multi-click time has been read from the X
+ * resource database.  hook_get_multi_click_time() only returns the cached
+ * value, so this should only change when the database changes.
+ */
+extern unsigned long get_multi_click_time_lookups();
+
+/* Returns the number of XkbGetIndicatorState() requests made by the hook.
+ * When indicator notifications are in use this only changes when the hook
+ * starts, never per key event.
+ */
+extern unsigned long get_indicator_state_queries();
+
+/* Decode a recorded XRecord element and dispatch the resulting events without
+ * freeing it.  This is the body of the XRecord callback and is exposed so that
+ * fabricated data can be fed through the same path.
+ */
+extern void process_intercept_data(XRecordInterceptData *recorded_data);
+
+/* Set up the hook state required by process_intercept_data() without starting
+ * XRecord.  Only an X display for the keyboard state is needed.  The hook must
+ * not be running.  Returns UIOHOOK_SUCCESS or the hook_run() error status.
+ */
+extern int create_synthetic_hook();
+
+/* Release the state created by create_synthetic_hook().
+ */
+extern void destroy_synthetic_hook();
+
+/* Make hook_replay() pass events to sink instead of posting them, or restore
+ * hook_post_events() if sink is NULL.
+ */
+extern void set_replay_sink(replay_sink_t sink);
+#endif
+
 /* Converts a X11 key symbol to a single Unicode character.  No direct X11
  * functionality exists to provide this information.
  */
 extern size_t keysym_to_unicode(KeySym keysym, uint16_t *buffer, size_t size);
 
+/* Binary search the keysym to Unicode table without the page table used by
+ * keysym_to_unicode().  Returns 0 for unmapped keysyms.  Only used to verify
+ * that both tables agree.
+ */
+extern uint16_t keysym_table_search(KeySym keysym);
+
 /* Convert a single Unicode character to a X11 key symbol.  This function
  * provides a better translation than XStringToKeysym() for Unicode characters.
  */
@@ -69,7 +179,9 @@ extern KeyCode scancode_to_keycode(uint16_t scancode);
  */
 extern size_t keycode_to_unicode(struct xkb_state* state, KeyCode keycode, uint16_t *buffer, size_t size);
 
-/* Create a xkb_state structure and return a pointer to it.
+/* Create a xkb_state structure and return a pointer to it.  The key
+ * translations used by translate_key() are built from its keymap and replace
+ * any earlier translations until unload_input_helper() releases them.
  */
 extern struct xkb_state * create_xkb_state(struct xkb_context *context, xcb_connection_t *connection);
 
@@ -77,24 +189,55 @@ extern struct xkb_state * create_xkb_state(struct xkb_context *context, xcb_conn
  */
 extern void destroy_xkb_state(struct xkb_state* state);
 
+/* Set the state to the core modifiers and group recorded with a key event.
+ * The state is driven by this alone, never by xkb_state_update_key(), so it
+ * always matches the server when the event was generated.
+ */
+extern void update_xkb_state(struct xkb_state *state, unsigned int modifier_mask);
+
+/* Translate a key event to its keysym, scan code and characters.  The keymap
+ * is read from the translation table, only the group and shift level come from
+ * the state.  While Control or Caps Lock is active xkbcommon does the lookup.
+ */
+extern key_translation translate_key(struct xkb_state *state, KeyCode keycode);
+
 #else
 
-/* Converts a X11 key code and event mask to the appropriate X11 key symbol.
- * This functions in much the same way as XKeycodeToKeysym() but allows for a
- * faster and more flexible lookup.
+/* Translate a key event to its keysym, scan code and characters using the
+ * group and modifiers of the event state.  This replaces XKeycodeToKeysym()
+ * with a few reads from a table built by load_input_helper().
+ */
+extern key_translation translate_key(KeyCode keycode, unsigned int modifier_mask);
+
+/* Build and publish the key translations for a keyboard mapping.  The
+ * translations are released by unload_input_helper().
  */
-extern KeySym keycode_to_keysym(KeyCode keycode, unsigned int modifier_mask);
+extern void load_key_translations(XkbDescPtr map);
+
+/* Rebuild the key translations from the current keyboard mapping.  Called by
+ * the settings thread when the mapping changes, does nothing while the input
+ * helper is not loaded.
+ */
+extern void reload_key_translations(Display *disp);
 
 #endif
 
-/* Lookup a X11 buttons possible remapping and return that value.
+/* Lookup a X11 buttons possible remapping and return that value.  This only
+ * reads the mapping cached by update_button_map().
  */
 extern unsigned int button_map_lookup(unsigned int button);
 
+/* Fetch the pointer button mapping from the X server and replace the cached
+ * mapping.  Called by LoadInputHelper() and whenever a MappingNotify for the
+ * pointer is received.
+ */
+extern void update_button_map(Display *disp);
+
 /* Initialize items required for KeyCodeToKeySym() and KeySymToUnicode()
- * functionality.  This method is called by OnLibraryLoad() and may need to be
- * called in combination with UnloadInputHelper() if the native keyboard layout
- * is changed.
+ * functionality.  This method is called when the hook starts, opening the
+ * helper display and settings thread on first use, and may need to be called
+ * in combination with UnloadInputHelper() if the native keyboard layout is
+ * changed.
  */
 extern void load_input_helper();
 
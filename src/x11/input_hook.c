@@ -18,9 +18,21 @@
 
 #include <inttypes.h>
 #include <limits.h>
+#include <errno.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <sys/eventfd.h>
+#endif
 
 #ifdef USE_XRECORD_ASYNC
-#include <pthread.h>
+#include <poll.h>
+#include <time.h>
+
+#ifndef __linux__
+#error "USE_XRECORD_ASYNC requires eventfd, which is only available on Linux!"
+#endif
 #endif
 
 #include <stdint.h>
@@ -34,41 +46,57 @@
 #include <X11/Xlib.h>
 #include <X11/extensions/record.h>
 
-#if defined(USE_XINERAMA) && !defined(USE_XRANDR)
-#include <X11/extensions/Xinerama.h>
-#elif defined(USE_XRANDR)
-#include <X11/extensions/Xrandr.h>
-#else
+#ifdef USE_XCB_RECORD
+#include <string.h>
+#include <X11/Xlib-xcb.h>
+#include <xcb/record.h>
+
+#ifdef USE_XRECORD_ASYNC
+#error "USE_XCB_RECORD does not support USE_XRECORD_ASYNC!"
+#endif
+#endif
+
+#if !defined(USE_XINERAMA) && !defined(USE_XRANDR)
 // TODO We may need to fallback to the xf86vm extension for things like TwinView.
 #pragma message("*** Warning: Xinerama or XRandR support is required to produce cross-platform mouse coordinates for multi-head configurations!")
 #pragma message("... Assuming single-head display.")
 #endif
 
+#include "dispatch_queue.h"
 #include "logger.h"
 #include "input_helper.h"
 
 // Thread and hook handles.
-#ifdef USE_XRECORD_ASYNC
-static bool running;
-
-static pthread_cond_t hook_xrecord_cond = PTHREAD_COND_INITIALIZER;
-static pthread_mutex_t hook_xrecord_mutex = PTHREAD_MUTEX_INITIALIZER;
-#endif
-
 typedef struct _hook_info {
     struct _data {
         Display *display;
         XRecordRange *range;
+        #ifdef USE_XRECORD_ASYNC
+        // Signaled by hook_stop() to end the async loop.
+        int stop_fd;
+
+        // Set once the end of data has been processed.
+        bool end_of_data;
+        #endif
     } data;
     struct _ctrl {
         Display *display;
         XRecordContext context;
+        #if (defined(USE_XKB_COMMON) && defined(USE_XKB_STATE_EVENTS)) \
+                || (!defined(USE_XKB_COMMON) && defined(USE_XKB_INDICATOR_EVENTS))
+        int xkb_event_base;
+        #endif
     } ctrl;
     struct _input {
         #ifdef USE_XKB_COMMON
         xcb_connection_t *connection;
         struct xkb_context *context;
         #endif
+        #if defined(USE_XKB_COMMON) || defined(USE_XKB_INDICATOR_EVENTS)
+        // Core modifiers bound to Num Lock and Scroll Lock, 0 if there is none.
+        unsigned int num_lock_mask;
+        unsigned int scroll_lock_mask;
+        #endif
         uint16_t mask;
         struct _mouse {
             bool is_dragged;
@@ -82,6 +110,17 @@ typedef struct _hook_info {
 } hook_info;
 static hook_info *hook;
 
+// Held while the hook or its record context is created or torn down, and by
+// hook_stop() and hook_set_event_mask() while they use the running context.
+static pthread_mutex_t hook_control_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+// Publish or retire the record context used by other threads.
+static void set_record_context(XRecordContext context) {
+    pthread_mutex_lock(&hook_control_mutex);
+    hook->ctrl.context = context;
+    pthread_mutex_unlock(&hook_control_mutex);
+}
+
 // For this struct, refer to libxnee, requires Xlibint.h
 typedef union {
     unsigned char       type;
@@ -96,12 +135,33 @@ typedef union {
 static struct xkb_state *state = NULL;
 #endif
 
+#ifdef USE_SYNTHETIC_HOOK
+// Number of XkbGetIndicatorState() requests made by the hook.
+static unsigned long indicator_state_queries = 0;
+#endif
+
 // Virtual event pointer.
 static uiohook_event event;
 
 // Event dispatch callback.
 static dispatcher_t dispatcher = NULL;
 
+// Event types passed to the dispatcher, see hook_set_event_mask().
+static uint32_t event_mask = EVENT_MASK_ALL;
+
+// Queue between the hook and dispatch threads, only set by hook_run_async().
+static dispatch_queue *queue = NULL;
+static bool queue_block = false;
+static dispatch_stats queue_stats = { 0, 0 };
+
+// Queue drained by hook_read_events(), only set by hook_open_event_fd().
+static dispatch_queue *fd_queue = NULL;
+static bool fd_queue_block = false;
+static int event_fd = -1;
+
+// Set while event_fd is readable so the hook only writes it once per drain.
+static bool event_fd_signaled = false;
+
 UIOHOOK_API void hook_set_dispatch_proc(dispatcher_t dispatch_proc) {
     logger(LOG_LEVEL_DEBUG, "%s [%u]: Setting new dispatch callback to %#p.\n",
             __FUNCTION__, __LINE__, dispatch_proc);
@@ -109,9 +169,40 @@ UIOHOOK_API void hook_set_dispatch_proc(dispatcher_t dispatch_proc) {
     dispatcher = dispatch_proc;
 }
 
+// Make event_fd readable.
+static void signal_event_fd() {
+    uint64_t value = 1;
+    while (write(event_fd, &value, sizeof(value)) < 0 && errno == EINTR);
+}
+
 // Send out an event if a dispatcher was set.
 static inline void dispatch_event(uiohook_event *const event) {
-    if (dispatcher != NULL) {
+    // Events recorded only to track state are not passed on.
+    if (event->type != EVENT_HOOK_ENABLED && event->type != EVENT_HOOK_DISABLED
+            && !(__atomic_load_n(&event_mask, __ATOMIC_RELAXED) & EVENT_TYPE_MASK(event->type))) {
+        return;
+    }
+
+    dispatch_queue *reader = __atomic_load_n(&fd_queue, __ATOMIC_ACQUIRE);
+    if (reader != NULL) {
+        // Events are read by the owner of event_fd instead of the dispatcher.
+        if (dispatch_queue_push(reader, event, fd_queue_block)) {
+            __atomic_add_fetch(&queue_stats.enqueued, 1, __ATOMIC_RELAXED);
+
+            if (!__atomic_exchange_n(&event_fd_signaled, true, __ATOMIC_SEQ_CST)) {
+                signal_event_fd();
+            }
+        } else {
+            __atomic_add_fetch(&queue_stats.dropped, 1, __ATOMIC_RELAXED);
+        }
+    } else if (queue != NULL) {
+        // The dispatch thread calls the dispatcher with its own copy.
+        if (dispatch_queue_push(queue, event, queue_block)) {
+            __atomic_add_fetch(&queue_stats.enqueued, 1, __ATOMIC_RELAXED);
+        } else {
+            __atomic_add_fetch(&queue_stats.dropped, 1, __ATOMIC_RELAXED);
+        }
+    } else if (dispatcher != NULL) {
         logger(LOG_LEVEL_DEBUG, "%s [%u]: Dispatching event type %u.\n",
                 __FUNCTION__, __LINE__, event->type);
 
@@ -137,6 +228,42 @@ static inline uint16_t get_modifiers() {
     return hook->input.mask;
 }
 
+// Offset root window coordinates by the origin of the primary screen.
+static inline void adjust_screen_offset(int16_t *x, int16_t *y) {
+    #if defined(USE_XINERAMA) || defined(USE_XRANDR)
+    unsigned int slot;
+    const screen_layout *layout = get_screen_layout(&slot);
+    if (layout != NULL && layout->count > 1) {
+        *x -= layout->screens[0].x;
+        *y -= layout->screens[0].y;
+    }
+    put_screen_layout(slot);
+    #endif
+}
+
+#ifndef USE_XKB_COMMON
+// Set the modifier lock masks from a keyboard indicator mask.
+static void set_lock_masks(unsigned int led_mask) {
+    if (led_mask & 0x01) {
+        set_modifier_mask(MASK_CAPS_LOCK);
+    } else {
+        unset_modifier_mask(MASK_CAPS_LOCK);
+    }
+
+    if (led_mask & 0x02) {
+        set_modifier_mask(MASK_NUM_LOCK);
+    } else {
+        unset_modifier_mask(MASK_NUM_LOCK);
+    }
+
+    if (led_mask & 0x04) {
+        set_modifier_mask(MASK_SCROLL_LOCK);
+    } else {
+        unset_modifier_mask(MASK_SCROLL_LOCK);
+    }
+}
+#endif
+
 // Initialize the modifier lock masks.
 static void initialize_locks() {
     #ifdef USE_XKB_COMMON
@@ -159,31 +286,208 @@ static void initialize_locks() {
     }
     #else
     unsigned int led_mask = 0x00;
+    #ifdef USE_SYNTHETIC_HOOK
+    __atomic_add_fetch(&indicator_state_queries, 1, __ATOMIC_RELAXED);
+    #endif
     if (XkbGetIndicatorState(hook->ctrl.display, XkbUseCoreKbd, &led_mask) == Success) {
-        if (led_mask & 0x01) {
-            set_modifier_mask(MASK_CAPS_LOCK);
-        } else {
-            unset_modifier_mask(MASK_CAPS_LOCK);
+        set_lock_masks(led_mask);
+    } else {
+        logger(LOG_LEVEL_WARN, "%s [%u]: XkbGetIndicatorState failed to get current led mask!\n",
+                __FUNCTION__, __LINE__);
+    }
+    #endif
+}
+
+#if !defined(USE_XKB_COMMON) && defined(USE_XKB_INDICATOR_EVENTS)
+// Select indicator change notifications on the control display.
+static bool select_indicator_events() {
+    int opcode, error_base;
+    int major = XkbMajorVersion, minor = XkbMinorVersion;
+
+    hook->ctrl.xkb_event_base = -1;
+    if (!XkbQueryExtension(hook->ctrl.display, &opcode, &hook->ctrl.xkb_event_base, &error_base, &major, &minor)) {
+        hook->ctrl.xkb_event_base = -1;
+        return false;
+    }
+
+    if (!XkbSelectEventDetails(hook->ctrl.display, XkbUseCoreKbd, XkbIndicatorStateNotify,
+            XkbAllIndicatorsMask, XkbAllIndicatorsMask)) {
+        hook->ctrl.xkb_event_base = -1;
+        return false;
+    }
+
+    return true;
+}
+
+// Apply indicator notifications already received on the control display.
+static void process_indicator_events() {
+    XEvent xev;
+
+    // QueuedAfterReading only reads what the server has already sent, it never
+    // flushes or issues a request.
+    while (XEventsQueued(hook->ctrl.display, QueuedAfterReading) > 0) {
+        XNextEvent(hook->ctrl.display, &xev);
+
+        if (xev.type == hook->ctrl.xkb_event_base) {
+            XkbEvent *xkb_event = (XkbEvent *) &xev;
+            if (xkb_event->any.xkb_type == XkbIndicatorStateNotify) {
+                set_lock_masks(xkb_event->indicators.state);
+            }
         }
+    }
+}
+#endif
 
-        if (led_mask & 0x02) {
-            set_modifier_mask(MASK_NUM_LOCK);
-        } else {
-            unset_modifier_mask(MASK_NUM_LOCK);
+#if defined(USE_XKB_COMMON) && defined(USE_XKB_STATE_EVENTS)
+// Select keymap change notifications on the control display.
+static bool select_xkb_events() {
+    int opcode, error_base;
+    int major = XkbMajorVersion, minor = XkbMinorVersion;
+
+    hook->ctrl.xkb_event_base = -1;
+    if (!XkbQueryExtension(hook->ctrl.display, &opcode, &hook->ctrl.xkb_event_base, &error_base, &major, &minor)) {
+        hook->ctrl.xkb_event_base = -1;
+        return false;
+    }
+
+    // Only the parts of the keymap that xkbcommon compiles.
+    unsigned int map_parts = XkbKeyTypesMask | XkbKeySymsMask | XkbModifierMapMask
+            | XkbExplicitComponentsMask | XkbKeyActionsMask | XkbVirtualModsMask | XkbVirtualModMapMask;
+
+    if (!XkbSelectEventDetails(hook->ctrl.display, XkbUseCoreKbd, XkbNewKeyboardNotify,
+                XkbNKN_KeycodesMask, XkbNKN_KeycodesMask)
+            || !XkbSelectEventDetails(hook->ctrl.display, XkbUseCoreKbd, XkbMapNotify, map_parts, map_parts)) {
+        hook->ctrl.xkb_event_base = -1;
+        return false;
+    }
+
+    return true;
+}
+
+/* Apply keymap notifications already received on the control display.  The
+ * state itself is only set from the recorded key events, see
+ * update_xkb_state().
+ */
+static void process_xkb_events() {
+    XEvent xev;
+    bool keymap_changed = false;
+
+    // QueuedAfterReading only reads what the server has already sent, it never
+    // flushes or issues a request.
+    while (XEventsQueued(hook->ctrl.display, QueuedAfterReading) > 0) {
+        XNextEvent(hook->ctrl.display, &xev);
+
+        if (xev.type == hook->ctrl.xkb_event_base) {
+            XkbEvent *xkb_event = (XkbEvent *) &xev;
+            if (xkb_event->any.xkb_type == XkbNewKeyboardNotify || xkb_event->any.xkb_type == XkbMapNotify) {
+                keymap_changed = true;
+            }
         }
+    }
 
-        if (led_mask & 0x04) {
-            set_modifier_mask(MASK_SCROLL_LOCK);
+    // A single layout change sends several notifications, compile the keymap once.
+    if (keymap_changed) {
+        struct xkb_state *next = create_xkb_state(hook->input.context, hook->input.connection);
+        if (next != NULL) {
+            logger(LOG_LEVEL_DEBUG, "%s [%u]: Reloaded the keymap after a keyboard mapping change.\n",
+                    __FUNCTION__, __LINE__);
+
+            if (state != NULL) {
+                destroy_xkb_state(state);
+            }
+            state = next;
         } else {
+            logger(LOG_LEVEL_WARN, "%s [%u]: Failed to reload the keymap!\n",
+                    __FUNCTION__, __LINE__);
+        }
+    }
+}
+#endif
+
+#if defined(USE_XKB_COMMON) || defined(USE_XKB_INDICATOR_EVENTS)
+/* Set one lock mask from the core modifier bound to it in the recorded state.
+ * The recorded state holds the locks in effect for the event itself, except
+ * on the lock key where it predates the change: the press inverts the recorded
+ * lock, and the release, which still carries a lock the key is about to clear,
+ * leaves the mask alone.
+ */
+static void set_recorded_lock(uint16_t mask, unsigned int lock_modifier, unsigned int modifier_state,
+        bool is_lock_key, bool is_press) {
+    bool locked = (modifier_state & lock_modifier) != 0;
+    if (is_lock_key) {
+        if (!is_press) {
+            return;
+        }
+
+        locked = !locked;
+    }
+
+    if (locked) {
+        set_modifier_mask(mask);
+    } else {
+        unset_modifier_mask(mask);
+    }
+}
+
+// Set the lock masks from the locked modifiers recorded with a key event.
+static void set_recorded_locks(unsigned int modifier_state, KeySym keysym, bool is_press) {
+    set_recorded_lock(MASK_CAPS_LOCK, LockMask, modifier_state, keysym == XK_Caps_Lock, is_press);
+
+    if (hook->input.num_lock_mask != 0) {
+        set_recorded_lock(MASK_NUM_LOCK, hook->input.num_lock_mask, modifier_state,
+                keysym == XK_Num_Lock, is_press);
+    }
+
+    if (hook->input.scroll_lock_mask != 0) {
+        set_recorded_lock(MASK_SCROLL_LOCK, hook->input.scroll_lock_mask, modifier_state,
+                keysym == XK_Scroll_Lock, is_press);
+    }
+    #ifdef USE_XKB_COMMON
+    else if (keysym == XK_Scroll_Lock && is_press) {
+        // Scroll Lock is rarely bound to a modifier, follow its key instead.
+        if (get_modifiers() & MASK_SCROLL_LOCK) {
             unset_modifier_mask(MASK_SCROLL_LOCK);
+        } else {
+            set_modifier_mask(MASK_SCROLL_LOCK);
         }
+    }
+    #endif
+}
+#endif
+
+/* Update the modifier lock masks after a key event with the recorded core
+ * modifier state and keysym of the event.
+ */
+static void update_locks(unsigned int modifier_state, KeySym keysym, bool is_press) {
+    #ifdef USE_XKB_COMMON
+    /* The xkb_state only holds the effective modifiers of the last recorded
+     * event, so its indicators are not used past initialize_locks().
+     */
+    set_recorded_locks(modifier_state, keysym, is_press);
+    #elif defined(USE_XKB_INDICATOR_EVENTS)
+    if (hook->ctrl.xkb_event_base >= 0) {
+        process_indicator_events();
+
+        /* Indicator notifications arrive on the control display and can trail
+         * the recorded key events, so typing right after a lock key would use
+         * the old lock state.  Scroll Lock without a modifier still trails by
+         * one notification.
+         */
+        set_recorded_locks(modifier_state, keysym, is_press);
     } else {
-        logger(LOG_LEVEL_WARN, "%s [%u]: XkbGetIndicatorState failed to get current led mask!\n",
-                __FUNCTION__, __LINE__);
+        initialize_locks();
     }
+    #else
+    initialize_locks();
     #endif
 }
 
+#ifdef USE_SYNTHETIC_HOOK
+unsigned long get_indicator_state_queries() {
+    return __atomic_load_n(&indicator_state_queries, __ATOMIC_RELAXED);
+}
+#endif
+
 // Initialize the modifier mask to the current modifiers.
 static void initialize_modifiers() {
     hook->input.mask = 0x0000;
@@ -251,551 +555,550 @@ static void initialize_modifiers() {
     initialize_locks();
 }
 
-void hook_event_proc(XPointer closeure, XRecordInterceptData *recorded_data) {
-    uint64_t timestamp = (uint64_t) recorded_data->server_time;
+// Process the start of recorded data.
+static void process_start_of_data(uint64_t timestamp) {
+    // Initialize native input helper functions.
+    load_input_helper();
 
-    if (recorded_data->category == XRecordStartOfData) {
-        // Initialize native input helper functions.
-        load_input_helper();
+    // Populate the hook start event.
+    event.time = timestamp;
+    event.reserved = 0x00;
 
-        // Populate the hook start event.
-        event.time = timestamp;
-        event.reserved = 0x00;
+    event.type = EVENT_HOOK_ENABLED;
+    event.mask = 0x00;
 
-        event.type = EVENT_HOOK_ENABLED;
-        event.mask = 0x00;
+    // Fire the hook start event.
+    dispatch_event(&event);
+}
 
-        // Fire the hook start event.
-        dispatch_event(&event);
-    } else if (recorded_data->category == XRecordEndOfData) {
-        // Populate the hook stop event.
-        event.time = timestamp;
-        event.reserved = 0x00;
+// Process the end of recorded data.
+static void process_end_of_data(uint64_t timestamp) {
+    // Populate the hook stop event.
+    event.time = timestamp;
+    event.reserved = 0x00;
 
-        event.type = EVENT_HOOK_DISABLED;
-        event.mask = 0x00;
+    event.type = EVENT_HOOK_DISABLED;
+    event.mask = 0x00;
 
-        // Fire the hook stop event.
-        dispatch_event(&event);
+    // Fire the hook stop event.
+    dispatch_event(&event);
 
-        // Deinitialize native input helper functions.
-        unload_input_helper();
-    } else if (recorded_data->category == XRecordFromServer || recorded_data->category == XRecordFromClient) {
-        // Get XRecord data.
-        XRecordDatum *data = (XRecordDatum *) recorded_data->data;
-
-        if (data->type == KeyPress) {
-            // The X11 KeyCode associated with this event.
-            KeyCode keycode = (KeyCode) data->event.u.u.detail;
-            KeySym keysym = 0x00;
-            #if defined(USE_XKB_COMMON)
-            if (state != NULL) {
-                keysym = xkb_state_key_get_one_sym(state, keycode);
-            }
-            #else
-            keysym = keycode_to_keysym(keycode, data->event.u.keyButtonPointer.state);
-            #endif
-
-            // Check to make sure the key is printable.
-            uint16_t buffer[2];
-            size_t count =  0;
-            #ifdef USE_XKB_COMMON
-            if (state != NULL) {
-                count = keycode_to_unicode(state, keycode, buffer, sizeof(buffer) / sizeof(uint16_t));
-            }
-            #else
-            count = keysym_to_unicode(keysym, buffer, sizeof(buffer) / sizeof(uint16_t));
-            #endif
-
-
-            unsigned short int scancode = keycode_to_scancode(keycode);
-
-            // TODO If you have a better suggestion for this ugly, let me know.
-            if      (scancode == VC_SHIFT_L)   { set_modifier_mask(MASK_SHIFT_L); }
-            else if (scancode == VC_SHIFT_R)   { set_modifier_mask(MASK_SHIFT_R); }
-            else if (scancode == VC_CONTROL_L) { set_modifier_mask(MASK_CTRL_L);  }
-            else if (scancode == VC_CONTROL_R) { set_modifier_mask(MASK_CTRL_R);  }
-            else if (scancode == VC_ALT_L)     { set_modifier_mask(MASK_ALT_L);   }
-            else if (scancode == VC_ALT_R)     { set_modifier_mask(MASK_ALT_R);   }
-            else if (scancode == VC_META_L)    { set_modifier_mask(MASK_META_L);  }
-            else if (scancode == VC_META_R)    { set_modifier_mask(MASK_META_R);  }
-            #ifdef USE_XKB_COMMON
-            xkb_state_update_key(state, keycode, XKB_KEY_DOWN);
-            #endif
-            initialize_locks();
-
-
-            if ((get_modifiers() & MASK_NUM_LOCK) == 0) {
-                switch (scancode) {
-                    case VC_KP_SEPARATOR:
-                    case VC_KP_1:
-                    case VC_KP_2:
-                    case VC_KP_3:
-                    case VC_KP_4:
-                    case VC_KP_5:
-                    case VC_KP_6:
-                    case VC_KP_7:
-                    case VC_KP_8:
-                    case VC_KP_0:
-                    case VC_KP_9:
-                        scancode |= 0xEE00;
-                        break;
-                }
-            }
+    // Deinitialize native input helper functions.
+    unload_input_helper();
+
+    #ifdef USE_XRECORD_ASYNC
+    if (hook != NULL) {
+        hook->data.end_of_data = true;
+    }
+    #endif
+}
+
+// Process a core KeyPress.
+static void process_key_pressed(uint64_t timestamp, XRecordDatum *data) {
+    // The X11 KeyCode associated with this event.
+    KeyCode keycode = (KeyCode) data->event.u.u.detail;
 
-            // Populate key pressed event.
+    #if defined(USE_XKB_COMMON) && defined(USE_XKB_STATE_EVENTS)
+    // Pick up layout and keymap changes made since the last key event.
+    if (hook->ctrl.xkb_event_base >= 0) {
+        process_xkb_events();
+    }
+    #endif
+
+    // Keysym, scan code and printable characters from the translation table.
+    #ifdef USE_XKB_COMMON
+    update_xkb_state(state, data->event.u.keyButtonPointer.state);
+    key_translation translation = translate_key(state, keycode);
+    #else
+    key_translation translation = translate_key(keycode, data->event.u.keyButtonPointer.state);
+    #endif
+    KeySym keysym = translation.keysym;
+    const uint16_t *buffer = translation.unicode;
+    size_t count = translation.count;
+
+    unsigned short int scancode = translation.scancode;
+
+    // TODO If you have a better suggestion for this ugly, let me know.
+    if      (scancode == VC_SHIFT_L)   { set_modifier_mask(MASK_SHIFT_L); }
+    else if (scancode == VC_SHIFT_R)   { set_modifier_mask(MASK_SHIFT_R); }
+    else if (scancode == VC_CONTROL_L) { set_modifier_mask(MASK_CTRL_L);  }
+    else if (scancode == VC_CONTROL_R) { set_modifier_mask(MASK_CTRL_R);  }
+    else if (scancode == VC_ALT_L)     { set_modifier_mask(MASK_ALT_L);   }
+    else if (scancode == VC_ALT_R)     { set_modifier_mask(MASK_ALT_R);   }
+    else if (scancode == VC_META_L)    { set_modifier_mask(MASK_META_L);  }
+    else if (scancode == VC_META_R)    { set_modifier_mask(MASK_META_R);  }
+    update_locks(data->event.u.keyButtonPointer.state, keysym, true);
+
+
+    if ((get_modifiers() & MASK_NUM_LOCK) == 0) {
+        switch (scancode) {
+            case VC_KP_SEPARATOR:
+            case VC_KP_1:
+            case VC_KP_2:
+            case VC_KP_3:
+            case VC_KP_4:
+            case VC_KP_5:
+            case VC_KP_6:
+            case VC_KP_7:
+            case VC_KP_8:
+            case VC_KP_0:
+            case VC_KP_9:
+                scancode |= 0xEE00;
+                break;
+        }
+    }
+
+    // Populate key pressed event.
+    event.time = timestamp;
+    event.reserved = 0x00;
+
+    event.type = EVENT_KEY_PRESSED;
+    event.mask = get_modifiers();
+
+    event.data.keyboard.keycode = scancode;
+    event.data.keyboard.rawcode = keysym;
+    event.data.keyboard.keychar = CHAR_UNDEFINED;
+
+    logger(LOG_LEVEL_DEBUG, "%s [%u]: Key %#X pressed. (%#X)\n",
+            __FUNCTION__, __LINE__, event.data.keyboard.keycode, event.data.keyboard.rawcode);
+
+    // Fire key pressed event.
+    dispatch_event(&event);
+
+    // If the pressed event was not consumed...
+    if (event.reserved ^ 0x01) {
+        for (unsigned int i = 0; i < count; i++) {
+            // Populate key typed event.
             event.time = timestamp;
             event.reserved = 0x00;
 
-            event.type = EVENT_KEY_PRESSED;
+            event.type = EVENT_KEY_TYPED;
             event.mask = get_modifiers();
 
-            event.data.keyboard.keycode = scancode;
+            event.data.keyboard.keycode = VC_UNDEFINED;
             event.data.keyboard.rawcode = keysym;
-            event.data.keyboard.keychar = CHAR_UNDEFINED;
+            event.data.keyboard.keychar = buffer[i];
 
-            logger(LOG_LEVEL_DEBUG, "%s [%u]: Key %#X pressed. (%#X)\n",
-                    __FUNCTION__, __LINE__, event.data.keyboard.keycode, event.data.keyboard.rawcode);
+            logger(LOG_LEVEL_DEBUG, "%s [%u]: Key %#X typed. (%lc)\n",
+                    __FUNCTION__, __LINE__, event.data.keyboard.keycode, (uint16_t) event.data.keyboard.keychar);
 
-            // Fire key pressed event.
+            // Fire key typed event.
             dispatch_event(&event);
+        }
+    }
+}
 
-            // If the pressed event was not consumed...
-            if (event.reserved ^ 0x01) {
-                for (unsigned int i = 0; i < count; i++) {
-                    // Populate key typed event.
-                    event.time = timestamp;
-                    event.reserved = 0x00;
+// Process a core KeyRelease.
+static void process_key_released(uint64_t timestamp, XRecordDatum *data) {
+    // The X11 KeyCode associated with this event.
+    KeyCode keycode = (KeyCode) data->event.u.u.detail;
 
-                    event.type = EVENT_KEY_TYPED;
-                    event.mask = get_modifiers();
+    #if defined(USE_XKB_COMMON) && defined(USE_XKB_STATE_EVENTS)
+    // Pick up layout and keymap changes made since the last key event.
+    if (hook->ctrl.xkb_event_base >= 0) {
+        process_xkb_events();
+    }
+    #endif
 
-                    event.data.keyboard.keycode = VC_UNDEFINED;
-                    event.data.keyboard.rawcode = keysym;
-                    event.data.keyboard.keychar = buffer[i];
+    // Keysym and scan code from the translation table.
+    #ifdef USE_XKB_COMMON
+    update_xkb_state(state, data->event.u.keyButtonPointer.state);
+    key_translation translation = translate_key(state, keycode);
+    #else
+    key_translation translation = translate_key(keycode, data->event.u.keyButtonPointer.state);
+    #endif
+    KeySym keysym = translation.keysym;
+
+    unsigned short int scancode = translation.scancode;
+
+    // TODO If you have a better suggestion for this ugly, let me know.
+    if      (scancode == VC_SHIFT_L)   { unset_modifier_mask(MASK_SHIFT_L); }
+    else if (scancode == VC_SHIFT_R)   { unset_modifier_mask(MASK_SHIFT_R); }
+    else if (scancode == VC_CONTROL_L) { unset_modifier_mask(MASK_CTRL_L);  }
+    else if (scancode == VC_CONTROL_R) { unset_modifier_mask(MASK_CTRL_R);  }
+    else if (scancode == VC_ALT_L)     { unset_modifier_mask(MASK_ALT_L);   }
+    else if (scancode == VC_ALT_R)     { unset_modifier_mask(MASK_ALT_R);   }
+    else if (scancode == VC_META_L)    { unset_modifier_mask(MASK_META_L);  }
+    else if (scancode == VC_META_R)    { unset_modifier_mask(MASK_META_R);  }
+    update_locks(data->event.u.keyButtonPointer.state, keysym, false);
+
+    if ((get_modifiers() & MASK_NUM_LOCK) == 0) {
+        switch (scancode) {
+            case VC_KP_SEPARATOR:
+            case VC_KP_1:
+            case VC_KP_2:
+            case VC_KP_3:
+            case VC_KP_4:
+            case VC_KP_5:
+            case VC_KP_6:
+            case VC_KP_7:
+            case VC_KP_8:
+            case VC_KP_0:
+            case VC_KP_9:
+                scancode |= 0xEE00;
+                break;
+        }
+    }
 
-                    logger(LOG_LEVEL_DEBUG, "%s [%u]: Key %#X typed. (%lc)\n",
-                            __FUNCTION__, __LINE__, event.data.keyboard.keycode, (uint16_t) event.data.keyboard.keychar);
+    // Populate key released event.
+    event.time = timestamp;
+    event.reserved = 0x00;
 
-                    // Fire key typed event.
-                    dispatch_event(&event);
-                }
-            }
-        } else if (data->type == KeyRelease) {
-            // The X11 KeyCode associated with this event.
-            KeyCode keycode = (KeyCode) data->event.u.u.detail;
-            KeySym keysym = 0x00;
-            #ifdef USE_XKB_COMMON
-            if (state != NULL) {
-                keysym = xkb_state_key_get_one_sym(state, keycode);
-            }
-            #else
-            keysym = keycode_to_keysym(keycode, data->event.u.keyButtonPointer.state);
-            #endif
+    event.type = EVENT_KEY_RELEASED;
+    event.mask = get_modifiers();
 
-            // Check to make sure the key is printable.
-            uint16_t buffer[2];
-            #ifdef USE_XKB_COMMON
-            if (state != NULL) {
-                keycode_to_unicode(state, keycode, buffer, sizeof(buffer) / sizeof(uint16_t));
-            }
-            #else
-            keysym_to_unicode(keysym, buffer, sizeof(buffer) / sizeof(uint16_t));
-            #endif
-
-            unsigned short int scancode = keycode_to_scancode(keycode);
-
-            // TODO If you have a better suggestion for this ugly, let me know.
-            if      (scancode == VC_SHIFT_L)   { unset_modifier_mask(MASK_SHIFT_L); }
-            else if (scancode == VC_SHIFT_R)   { unset_modifier_mask(MASK_SHIFT_R); }
-            else if (scancode == VC_CONTROL_L) { unset_modifier_mask(MASK_CTRL_L);  }
-            else if (scancode == VC_CONTROL_R) { unset_modifier_mask(MASK_CTRL_R);  }
-            else if (scancode == VC_ALT_L)     { unset_modifier_mask(MASK_ALT_L);   }
-            else if (scancode == VC_ALT_R)     { unset_modifier_mask(MASK_ALT_R);   }
-            else if (scancode == VC_META_L)    { unset_modifier_mask(MASK_META_L);  }
-            else if (scancode == VC_META_R)    { unset_modifier_mask(MASK_META_R);  }
-            #ifdef USE_XKB_COMMON
-            xkb_state_update_key(state, keycode, XKB_KEY_UP);
-            #endif
-            initialize_locks();
-
-            if ((get_modifiers() & MASK_NUM_LOCK) == 0) {
-                switch (scancode) {
-                    case VC_KP_SEPARATOR:
-                    case VC_KP_1:
-                    case VC_KP_2:
-                    case VC_KP_3:
-                    case VC_KP_4:
-                    case VC_KP_5:
-                    case VC_KP_6:
-                    case VC_KP_7:
-                    case VC_KP_8:
-                    case VC_KP_0:
-                    case VC_KP_9:
-                        scancode |= 0xEE00;
-                        break;
-                }
-            }
+    event.data.keyboard.keycode = scancode;
+    event.data.keyboard.rawcode = keysym;
+    event.data.keyboard.keychar = CHAR_UNDEFINED;
 
-            // Populate key released event.
-            event.time = timestamp;
-            event.reserved = 0x00;
+    logger(LOG_LEVEL_DEBUG, "%s [%u]: Key %#X released. (%#X)\n",
+            __FUNCTION__, __LINE__, event.data.keyboard.keycode, event.data.keyboard.rawcode);
 
-            event.type = EVENT_KEY_RELEASED;
-            event.mask = get_modifiers();
+    // Fire key released event.
+    dispatch_event(&event);
+}
 
-            event.data.keyboard.keycode = scancode;
-            event.data.keyboard.rawcode = keysym;
-            event.data.keyboard.keychar = CHAR_UNDEFINED;
+// Process a core ButtonPress, including wheel rotation.
+static void process_button_pressed(uint64_t timestamp, XRecordDatum *data) {
+    unsigned int map_button = button_map_lookup(data->event.u.u.detail);
 
-            logger(LOG_LEVEL_DEBUG, "%s [%u]: Key %#X released. (%#X)\n",
-                    __FUNCTION__, __LINE__, event.data.keyboard.keycode, event.data.keyboard.rawcode);
+    // X11 handles wheel events as button events.
+    if (map_button == WheelUp || map_button == WheelDown
+            || map_button == WheelLeft || map_button == WheelRight) {
 
-            // Fire key released event.
-            dispatch_event(&event);
-        } else if (data->type == ButtonPress) {
-            unsigned int map_button = button_map_lookup(data->event.u.u.detail);
-
-            // X11 handles wheel events as button events.
-            if (map_button == WheelUp || map_button == WheelDown
-                    || map_button == WheelLeft || map_button == WheelRight) {
-
-                // Reset the click count and previous button.
-                hook->input.mouse.click.count = 1;
-                hook->input.mouse.click.button = MOUSE_NOBUTTON;
-
-                /* Scroll wheel release events.
-                 * Scroll type: WHEEL_UNIT_SCROLL
-                 * Scroll amount: 3 unit increments per notch
-                 * Units to scroll: 3 unit increments
-                 * Vertical unit increment: 15 pixels
-                 */
-
-                // Populate mouse wheel event.
-                event.time = timestamp;
-                event.reserved = 0x00;
-
-                event.type = EVENT_MOUSE_WHEEL;
-                event.mask = get_modifiers();
-
-                event.data.wheel.clicks = hook->input.mouse.click.count;
-                event.data.wheel.x = data->event.u.keyButtonPointer.rootX;
-                event.data.wheel.y = data->event.u.keyButtonPointer.rootY;
-
-                #if defined(USE_XINERAMA) || defined(USE_XRANDR)
-                uint8_t count;
-                screen_data *screens = hook_create_screen_info(&count);
-                if (count > 1) {
-                    event.data.wheel.x -= screens[0].x;
-                    event.data.wheel.y -= screens[0].y;
-                }
+        // Reset the click count and previous button.
+        hook->input.mouse.click.count = 1;
+        hook->input.mouse.click.button = MOUSE_NOBUTTON;
 
-                if (screens != NULL) {
-                    free(screens);
-                }
-                #endif
-
-                /* X11 does not have an API call for acquiring the mouse scroll type.  This
-                 * maybe part of the XInput2 (XI2) extention but I will wont know until it
-                 * is available on my platform.  For the time being we will just use the
-                 * unit scroll value.
-                 */
-                event.data.wheel.type = WHEEL_UNIT_SCROLL;
-
-                /* Some scroll wheel properties are available via the new XInput2 (XI2)
-                 * extension.  Unfortunately the extension is not available on my
-                 * development platform at this time.  For the time being we will just
-                 * use the Windows default value of 3.
-                 */
-                event.data.wheel.amount = 3;
-
-                if (data->event.u.u.detail == WheelUp || data->event.u.u.detail == WheelLeft) {
-                    // Wheel Rotated Up and Away.
-                    event.data.wheel.rotation = -1;
-                } else { // data->event.u.u.detail == WheelDown
-                    // Wheel Rotated Down and Towards.
-                    event.data.wheel.rotation = 1;
-                }
+        /* Scroll wheel release events.
+         * Scroll type: WHEEL_UNIT_SCROLL
+         * Scroll amount: 3 unit increments per notch
+         * Units to scroll: 3 unit increments
+         * Vertical unit increment: 15 pixels
+         */
 
-                if (data->event.u.u.detail == WheelUp || data->event.u.u.detail == WheelDown) {
-                    // Wheel Rotated Up or Down.
-                    event.data.wheel.direction = WHEEL_VERTICAL_DIRECTION;
-                } else { // data->event.u.u.detail == WheelLeft || data->event.u.u.detail == WheelRight
-                    // Wheel Rotated Left or Right.
-                    event.data.wheel.direction = WHEEL_HORIZONTAL_DIRECTION;
-                }
+        // Populate mouse wheel event.
+        event.time = timestamp;
+        event.reserved = 0x00;
 
-                logger(LOG_LEVEL_DEBUG, "%s [%u]: Mouse wheel type %u, rotated %i units in the %u direction at %u, %u.\n",
-                        __FUNCTION__, __LINE__, event.data.wheel.type,
-                        event.data.wheel.amount * event.data.wheel.rotation,
-                        event.data.wheel.direction,
-                        event.data.wheel.x, event.data.wheel.y);
+        event.type = EVENT_MOUSE_WHEEL;
+        event.mask = get_modifiers();
+
+        event.data.wheel.clicks = hook->input.mouse.click.count;
+        event.data.wheel.x = data->event.u.keyButtonPointer.rootX;
+        event.data.wheel.y = data->event.u.keyButtonPointer.rootY;
+
+        adjust_screen_offset(&event.data.wheel.x, &event.data.wheel.y);
+
+        /* X11 does not have an API call for acquiring the mouse scroll type.  This
+         * maybe part of the XInput2 (XI2) extention but I will wont know until it
+         * is available on my platform.  For the time being we will just use the
+         * unit scroll value.
+         */
+        event.data.wheel.type = WHEEL_UNIT_SCROLL;
+
+        /* Some scroll wheel properties are available via the new XInput2 (XI2)
+         * extension.  Unfortunately the extension is not available on my
+         * development platform at this time.  For the time being we will just
+         * use the Windows default value of 3.
+         */
+        event.data.wheel.amount = 3;
+
+        if (data->event.u.u.detail == WheelUp || data->event.u.u.detail == WheelLeft) {
+            // Wheel Rotated Up and Away.
+            event.data.wheel.rotation = -1;
+        } else { // data->event.u.u.detail == WheelDown
+            // Wheel Rotated Down and Towards.
+            event.data.wheel.rotation = 1;
+        }
 
-                // Fire mouse wheel event.
-                dispatch_event(&event);
-            } else {
-                /* This information is all static for X11, its up to the WM to
-                 * decide how to interpret the wheel events.
-                 */
-                uint16_t button = MOUSE_NOBUTTON;
-                switch (map_button) {
-                    case Button1:
-                        button = MOUSE_BUTTON1;
-                        set_modifier_mask(MASK_BUTTON1);
-                        break;
-
-                    case Button2:
-                        button = MOUSE_BUTTON2;
-                        set_modifier_mask(MASK_BUTTON2);
-                        break;
-
-                    case Button3:
-                        button = MOUSE_BUTTON3;
-                        set_modifier_mask(MASK_BUTTON3);
-                        break;
-
-                    case XButton1:
-                        button = MOUSE_BUTTON4;
-                        set_modifier_mask(MASK_BUTTON5);
-                        break;
-
-                    case XButton2:
-                        button = MOUSE_BUTTON5;
-                        set_modifier_mask(MASK_BUTTON5);
-                        break;
-
-                    default:
-                        // Do not set modifier masks past button MASK_BUTTON5.
-                        break;
-                }
+        if (data->event.u.u.detail == WheelUp || data->event.u.u.detail == WheelDown) {
+            // Wheel Rotated Up or Down.
+            event.data.wheel.direction = WHEEL_VERTICAL_DIRECTION;
+        } else { // data->event.u.u.detail == WheelLeft || data->event.u.u.detail == WheelRight
+            // Wheel Rotated Left or Right.
+            event.data.wheel.direction = WHEEL_HORIZONTAL_DIRECTION;
+        }
 
+        logger(LOG_LEVEL_DEBUG, "%s [%u]: Mouse wheel type %u, rotated %i units in the %u direction at %u, %u.\n",
+                __FUNCTION__, __LINE__, event.data.wheel.type,
+                event.data.wheel.amount * event.data.wheel.rotation,
+                event.data.wheel.direction,
+                event.data.wheel.x, event.data.wheel.y);
 
-                // Track the number of clicks, the button must match the previous button.
-                if (button == hook->input.mouse.click.button && (long int) (timestamp - hook->input.mouse.click.time) <= hook_get_multi_click_time()) {
-                    if (hook->input.mouse.click.count < USHRT_MAX) {
-                        hook->input.mouse.click.count++;
-                    } else {
-                        logger(LOG_LEVEL_WARN, "%s [%u]: Click count overflow detected!\n",
-                                __FUNCTION__, __LINE__);
-                    }
-                } else {
-                    // Reset the click count.
-                    hook->input.mouse.click.count = 1;
+        // Fire mouse wheel event.
+        dispatch_event(&event);
+    } else {
+        /* This information is all static for X11, its up to the WM to
+         * decide how to interpret the wheel events.
+         */
+        uint16_t button = MOUSE_NOBUTTON;
+        switch (map_button) {
+            case Button1:
+                button = MOUSE_BUTTON1;
+                set_modifier_mask(MASK_BUTTON1);
+                break;
+
+            case Button2:
+                button = MOUSE_BUTTON2;
+                set_modifier_mask(MASK_BUTTON2);
+                break;
+
+            case Button3:
+                button = MOUSE_BUTTON3;
+                set_modifier_mask(MASK_BUTTON3);
+                break;
+
+            case XButton1:
+                button = MOUSE_BUTTON4;
+                set_modifier_mask(MASK_BUTTON5);
+                break;
+
+            case XButton2:
+                button = MOUSE_BUTTON5;
+                set_modifier_mask(MASK_BUTTON5);
+                break;
+
+            default:
+                // Do not set modifier masks past button MASK_BUTTON5.
+                break;
+        }
 
-                    // Set the previous button.
-                    hook->input.mouse.click.button = button;
-                }
 
-                // Save this events time to calculate the hook->input.mouse.click.count.
-                hook->input.mouse.click.time = timestamp;
+        // Track the number of clicks, the button must match the previous button.
+        if (button == hook->input.mouse.click.button && (long int) (timestamp - hook->input.mouse.click.time) <= get_multi_click_time()) {
+            if (hook->input.mouse.click.count < USHRT_MAX) {
+                hook->input.mouse.click.count++;
+            } else {
+                logger(LOG_LEVEL_WARN, "%s [%u]: Click count overflow detected!\n",
+                        __FUNCTION__, __LINE__);
+            }
+        } else {
+            // Reset the click count.
+            hook->input.mouse.click.count = 1;
 
+            // Set the previous button.
+            hook->input.mouse.click.button = button;
+        }
 
-                // Populate mouse pressed event.
-                event.time = timestamp;
-                event.reserved = 0x00;
+        // Save this events time to calculate the hook->input.mouse.click.count.
+        hook->input.mouse.click.time = timestamp;
 
-                event.type = EVENT_MOUSE_PRESSED;
-                event.mask = get_modifiers();
 
-                event.data.mouse.button = button;
-                event.data.mouse.clicks = hook->input.mouse.click.count;
-                event.data.mouse.x = data->event.u.keyButtonPointer.rootX;
-                event.data.mouse.y = data->event.u.keyButtonPointer.rootY;
+        // Populate mouse pressed event.
+        event.time = timestamp;
+        event.reserved = 0x00;
 
-                #if defined(USE_XINERAMA) || defined(USE_XRANDR)
-                uint8_t count;
-                screen_data *screens = hook_create_screen_info(&count);
-                if (count > 1) {
-                    event.data.mouse.x -= screens[0].x;
-                    event.data.mouse.y -= screens[0].y;
-                }
+        event.type = EVENT_MOUSE_PRESSED;
+        event.mask = get_modifiers();
 
-                if (screens != NULL) {
-                    free(screens);
-                }
-                #endif
+        event.data.mouse.button = button;
+        event.data.mouse.clicks = hook->input.mouse.click.count;
+        event.data.mouse.x = data->event.u.keyButtonPointer.rootX;
+        event.data.mouse.y = data->event.u.keyButtonPointer.rootY;
 
-                logger(LOG_LEVEL_DEBUG, "%s [%u]: Button %u  pressed %u time(s). (%u, %u)\n",
-                        __FUNCTION__, __LINE__, event.data.mouse.button, event.data.mouse.clicks,
-                        event.data.mouse.x, event.data.mouse.y);
+        adjust_screen_offset(&event.data.mouse.x, &event.data.mouse.y);
 
-                // Fire mouse pressed event.
-                dispatch_event(&event);
-            }
-        } else if (data->type == ButtonRelease) {
-            unsigned int map_button = button_map_lookup(data->event.u.u.detail);
-
-            // X11 handles wheel events as button events.
-            if (map_button != WheelUp && map_button != WheelDown
-                    && map_button != WheelLeft && map_button != WheelRight) {
-
-                /* This information is all static for X11, its up to the WM to
-                 * decide how to interpret the wheel events.
-                 */
-                uint16_t button = MOUSE_NOBUTTON;
-                switch (map_button) {
-                    // FIXME This should use a lookup table to handle button remapping.
-                    case Button1:
-                        button = MOUSE_BUTTON1;
-                        unset_modifier_mask(MASK_BUTTON1);
-                        break;
-
-                    case Button2:
-                        button = MOUSE_BUTTON2;
-                        unset_modifier_mask(MASK_BUTTON2);
-                        break;
-
-                    case Button3:
-                        button = MOUSE_BUTTON3;
-                        unset_modifier_mask(MASK_BUTTON3);
-                        break;
-
-                    case XButton1:
-                        button = MOUSE_BUTTON4;
-                        unset_modifier_mask(MASK_BUTTON5);
-                        break;
-
-                    case XButton2:
-                        button = MOUSE_BUTTON5;
-                        unset_modifier_mask(MASK_BUTTON5);
-                        break;
-
-                    default:
-                        // Do not set modifier masks past button MASK_BUTTON5.
-                        break;
-                }
+        logger(LOG_LEVEL_DEBUG, "%s [%u]: Button %u  pressed %u time(s). (%u, %u)\n",
+                __FUNCTION__, __LINE__, event.data.mouse.button, event.data.mouse.clicks,
+                event.data.mouse.x, event.data.mouse.y);
 
-                // Populate mouse released event.
-                event.time = timestamp;
-                event.reserved = 0x00;
+        // Fire mouse pressed event.
+        dispatch_event(&event);
+    }
+}
 
-                event.type = EVENT_MOUSE_RELEASED;
-                event.mask = get_modifiers();
+// Process a core ButtonRelease.
+static void process_button_released(uint64_t timestamp, XRecordDatum *data) {
+    unsigned int map_button = button_map_lookup(data->event.u.u.detail);
+
+    // X11 handles wheel events as button events.
+    if (map_button != WheelUp && map_button != WheelDown
+            && map_button != WheelLeft && map_button != WheelRight) {
+
+        /* This information is all static for X11, its up to the WM to
+         * decide how to interpret the wheel events.
+         */
+        uint16_t button = MOUSE_NOBUTTON;
+        switch (map_button) {
+            case Button1:
+                button = MOUSE_BUTTON1;
+                unset_modifier_mask(MASK_BUTTON1);
+                break;
+
+            case Button2:
+                button = MOUSE_BUTTON2;
+                unset_modifier_mask(MASK_BUTTON2);
+                break;
+
+            case Button3:
+                button = MOUSE_BUTTON3;
+                unset_modifier_mask(MASK_BUTTON3);
+                break;
+
+            case XButton1:
+                button = MOUSE_BUTTON4;
+                unset_modifier_mask(MASK_BUTTON5);
+                break;
+
+            case XButton2:
+                button = MOUSE_BUTTON5;
+                unset_modifier_mask(MASK_BUTTON5);
+                break;
+
+            default:
+                // Do not set modifier masks past button MASK_BUTTON5.
+                break;
+        }
 
-                event.data.mouse.button = button;
-                event.data.mouse.clicks = hook->input.mouse.click.count;
-                event.data.mouse.x = data->event.u.keyButtonPointer.rootX;
-                event.data.mouse.y = data->event.u.keyButtonPointer.rootY;
+        // Populate mouse released event.
+        event.time = timestamp;
+        event.reserved = 0x00;
 
-                #if defined(USE_XINERAMA) || defined(USE_XRANDR)
-                uint8_t count;
-                screen_data *screens = hook_create_screen_info(&count);
-                if (count > 1) {
-                    event.data.mouse.x -= screens[0].x;
-                    event.data.mouse.y -= screens[0].y;
-                }
+        event.type = EVENT_MOUSE_RELEASED;
+        event.mask = get_modifiers();
 
-                if (screens != NULL) {
-                    free(screens);
-                }
-                #endif
-
-                logger(LOG_LEVEL_DEBUG, "%s [%u]: Button %u released %u time(s). (%u, %u)\n",
-                        __FUNCTION__, __LINE__, event.data.mouse.button,
-                        event.data.mouse.clicks,
-                        event.data.mouse.x, event.data.mouse.y);
-
-                // Fire mouse released event.
-                dispatch_event(&event);
-
-                // If the pressed event was not consumed...
-                if (event.reserved ^ 0x01 && hook->input.mouse.is_dragged != true) {
-                    // Populate mouse clicked event.
-                    event.time = timestamp;
-                    event.reserved = 0x00;
-
-                    event.type = EVENT_MOUSE_CLICKED;
-                    event.mask = get_modifiers();
-
-                    event.data.mouse.button = button;
-                    event.data.mouse.clicks = hook->input.mouse.click.count;
-                    event.data.mouse.x = data->event.u.keyButtonPointer.rootX;
-                    event.data.mouse.y = data->event.u.keyButtonPointer.rootY;
-
-                    #if defined(USE_XINERAMA) || defined(USE_XRANDR)
-                    uint8_t count;
-                    screen_data *screens = hook_create_screen_info(&count);
-                    if (count > 1) {
-                        event.data.mouse.x -= screens[0].x;
-                        event.data.mouse.y -= screens[0].y;
-                    }
+        event.data.mouse.button = button;
+        event.data.mouse.clicks = hook->input.mouse.click.count;
+        event.data.mouse.x = data->event.u.keyButtonPointer.rootX;
+        event.data.mouse.y = data->event.u.keyButtonPointer.rootY;
 
-                    if (screens != NULL) {
-                        free(screens);
-                    }
-                    #endif
+        adjust_screen_offset(&event.data.mouse.x, &event.data.mouse.y);
 
-                    logger(LOG_LEVEL_DEBUG, "%s [%u]: Button %u clicked %u time(s). (%u, %u)\n",
-                            __FUNCTION__, __LINE__, event.data.mouse.button,
-                            event.data.mouse.clicks,
-                            event.data.mouse.x, event.data.mouse.y);
+        logger(LOG_LEVEL_DEBUG, "%s [%u]: Button %u released %u time(s). (%u, %u)\n",
+                __FUNCTION__, __LINE__, event.data.mouse.button,
+                event.data.mouse.clicks,
+                event.data.mouse.x, event.data.mouse.y);
 
-                    // Fire mouse clicked event.
-                    dispatch_event(&event);
-                }
+        // Fire mouse released event.
+        dispatch_event(&event);
 
-                // Reset the number of clicks.
-                if (button == hook->input.mouse.click.button && (long int) (event.time - hook->input.mouse.click.time) > hook_get_multi_click_time()) {
-                    // Reset the click count.
-                    hook->input.mouse.click.count = 0;
-                }
-            }
-        } else if (data->type == MotionNotify) {
-            // Reset the click count.
-            if (hook->input.mouse.click.count != 0 && (long int) (timestamp - hook->input.mouse.click.time) > hook_get_multi_click_time()) {
-                hook->input.mouse.click.count = 0;
-            }
-            
-            // Populate mouse move event.
+        // If the pressed event was not consumed...
+        if (event.reserved ^ 0x01 && hook->input.mouse.is_dragged != true) {
+            // Populate mouse clicked event.
             event.time = timestamp;
             event.reserved = 0x00;
 
+            event.type = EVENT_MOUSE_CLICKED;
             event.mask = get_modifiers();
 
-            // Check the upper half of virtual modifiers for non-zero values and set the mouse
-            // dragged flag.  The last 3 bits are reserved for lock masks.
-            hook->input.mouse.is_dragged = ((event.mask & 0x1F00) > 0);
-            if (hook->input.mouse.is_dragged) {
-                // Create Mouse Dragged event.
-                event.type = EVENT_MOUSE_DRAGGED;
-            } else {
-                // Create a Mouse Moved event.
-                event.type = EVENT_MOUSE_MOVED;
-            }
-
-            event.data.mouse.button = MOUSE_NOBUTTON;
+            event.data.mouse.button = button;
             event.data.mouse.clicks = hook->input.mouse.click.count;
             event.data.mouse.x = data->event.u.keyButtonPointer.rootX;
             event.data.mouse.y = data->event.u.keyButtonPointer.rootY;
 
-            #if defined(USE_XINERAMA) || defined(USE_XRANDR)
-            uint8_t count;
-            screen_data *screens = hook_create_screen_info(&count);
-            if (count > 1) {
-                event.data.mouse.x -= screens[0].x;
-                event.data.mouse.y -= screens[0].y;
-            }
-
-            if (screens != NULL) {
-                free(screens);
-            }
-            #endif
+            adjust_screen_offset(&event.data.mouse.x, &event.data.mouse.y);
 
-            logger(LOG_LEVEL_DEBUG, "%s [%u]: Mouse %s to %i, %i. (%#X)\n",
-                    __FUNCTION__, __LINE__, hook->input.mouse.is_dragged ? "dragged" : "moved",
-                    event.data.mouse.x, event.data.mouse.y, event.mask);
+            logger(LOG_LEVEL_DEBUG, "%s [%u]: Button %u clicked %u time(s). (%u, %u)\n",
+                    __FUNCTION__, __LINE__, event.data.mouse.button,
+                    event.data.mouse.clicks,
+                    event.data.mouse.x, event.data.mouse.y);
 
-            // Fire mouse move event.
+            // Fire mouse clicked event.
             dispatch_event(&event);
-        } else {
-            // In theory this *should* never execute.
-            logger(LOG_LEVEL_DEBUG, "%s [%u]: Unhandled X11 event: %#X.\n",
-                    __FUNCTION__, __LINE__, (unsigned int) data->type);
         }
-    } else {
-        logger(LOG_LEVEL_WARN, "%s [%u]: Unhandled X11 hook category! (%#X)\n",
-                __FUNCTION__, __LINE__, recorded_data->category);
-    }
+
+        // Reset the number of clicks.
+        if (button == hook->input.mouse.click.button && (long int) (event.time - hook->input.mouse.click.time) > get_multi_click_time()) {
+            // Reset the click count.
+            hook->input.mouse.click.count = 0;
+        }
+    }
+}
+
+// Process a core MotionNotify.
+static void process_motion_notify(uint64_t timestamp, XRecordDatum *data) {
+    // Reset the click count.
+    if (hook->input.mouse.click.count != 0 && (long int) (timestamp - hook->input.mouse.click.time) > get_multi_click_time()) {
+        hook->input.mouse.click.count = 0;
+    }
+    
+    // Populate mouse move event.
+    event.time = timestamp;
+    event.reserved = 0x00;
+
+    event.mask = get_modifiers();
+
+    // Check the upper half of virtual modifiers for non-zero values and set the mouse
+    // dragged flag.  The last 3 bits are reserved for lock masks.
+    hook->input.mouse.is_dragged = ((event.mask & 0x1F00) > 0);
+    if (hook->input.mouse.is_dragged) {
+        // Create Mouse Dragged event.
+        event.type = EVENT_MOUSE_DRAGGED;
+    } else {
+        // Create a Mouse Moved event.
+        event.type = EVENT_MOUSE_MOVED;
+    }
+
+    event.data.mouse.button = MOUSE_NOBUTTON;
+    event.data.mouse.clicks = hook->input.mouse.click.count;
+    event.data.mouse.x = data->event.u.keyButtonPointer.rootX;
+    event.data.mouse.y = data->event.u.keyButtonPointer.rootY;
+
+    adjust_screen_offset(&event.data.mouse.x, &event.data.mouse.y);
+
+    logger(LOG_LEVEL_DEBUG, "%s [%u]: Mouse %s to %i, %i. (%#X)\n",
+            __FUNCTION__, __LINE__, hook->input.mouse.is_dragged ? "dragged" : "moved",
+            event.data.mouse.x, event.data.mouse.y, event.mask);
+
+    // Fire mouse move event.
+    dispatch_event(&event);
+}
+
+// Process a single recorded core device event.
+static void process_datum(uint64_t timestamp, XRecordDatum *data) {
+    switch (data->type) {
+        case KeyPress:
+            process_key_pressed(timestamp, data);
+            break;
+
+        case KeyRelease:
+            process_key_released(timestamp, data);
+            break;
+
+        case ButtonPress:
+            process_button_pressed(timestamp, data);
+            break;
+
+        case ButtonRelease:
+            process_button_released(timestamp, data);
+            break;
+
+        case MotionNotify:
+            process_motion_notify(timestamp, data);
+            break;
+
+        default:
+            // In theory this *should* never execute.
+            logger(LOG_LEVEL_DEBUG, "%s [%u]: Unhandled X11 event: %#X.\n",
+                    __FUNCTION__, __LINE__, (unsigned int) data->type);
+            break;
+    }
+}
+
+static void process_recorded_data(XRecordInterceptData *recorded_data) {
+    uint64_t timestamp = (uint64_t) recorded_data->server_time;
+
+    if (recorded_data->category == XRecordStartOfData) {
+        process_start_of_data(timestamp);
+    } else if (recorded_data->category == XRecordEndOfData) {
+        process_end_of_data(timestamp);
+    } else if (recorded_data->category == XRecordFromServer || recorded_data->category == XRecordFromClient) {
+        process_datum(timestamp, (XRecordDatum *) recorded_data->data);
+    } else {
+        logger(LOG_LEVEL_WARN, "%s [%u]: Unhandled X11 hook category! (%#X)\n",
+                __FUNCTION__, __LINE__, recorded_data->category);
+    }
+}
+
+#ifdef USE_SYNTHETIC_HOOK
+void process_intercept_data(XRecordInterceptData *recorded_data) {
+    process_recorded_data(recorded_data);
+}
+#endif
+
+void hook_event_proc(XPointer closeure, XRecordInterceptData *recorded_data) {
+    process_recorded_data(recorded_data);
 
     // TODO There is no way to consume the XRecord event.
 
@@ -815,6 +1118,190 @@ static inline bool enable_key_repeate() {
 }
 
 
+/* Get the core event types XRecord intercepts for an event mask.  Key events
+ * are always needed for the modifier mask of every event and button events for
+ * the click and drag state of every mouse event, so only the more frequent
+ * MotionNotify and the button events can be left in the X server.
+ */
+static void get_record_range(uint32_t mask, unsigned char *first, unsigned char *last) {
+    if (mask & (EVENT_TYPE_MASK(EVENT_MOUSE_MOVED) | EVENT_TYPE_MASK(EVENT_MOUSE_DRAGGED))) {
+        *first = KeyPress;
+        *last = MotionNotify;
+    } else if (mask & (EVENT_TYPE_MASK(EVENT_MOUSE_PRESSED) | EVENT_TYPE_MASK(EVENT_MOUSE_RELEASED)
+            | EVENT_TYPE_MASK(EVENT_MOUSE_CLICKED) | EVENT_TYPE_MASK(EVENT_MOUSE_WHEEL))) {
+        *first = KeyPress;
+        *last = ButtonRelease;
+    } else if (mask & (EVENT_TYPE_MASK(EVENT_KEY_PRESSED) | EVENT_TYPE_MASK(EVENT_KEY_RELEASED)
+            | EVENT_TYPE_MASK(EVENT_KEY_TYPED))) {
+        *first = KeyPress;
+        *last = KeyRelease;
+    } else {
+        *first = 0;
+        *last = 0;
+    }
+}
+
+#ifdef USE_XCB_RECORD
+// Read a 32-bit value from a reply in the byte order of the recorded client.
+static inline uint32_t read_card32(const uint8_t *data, bool swapped) {
+    uint32_t value;
+    memcpy(&value, data, sizeof(value));
+
+    if (swapped) {
+        value = ((value & 0x000000FF) << 24) | ((value & 0x0000FF00) << 8)
+              | ((value & 0x00FF0000) >> 8)  | ((value & 0xFF000000) >> 24);
+    }
+
+    return value;
+}
+
+/* Process a batched xcb_record_enable_context reply.  The recorded events are
+ * read directly from the reply buffer, nothing is allocated per event.
+ */
+static void process_record_reply(xcb_record_enable_context_reply_t *reply) {
+    uint64_t timestamp = (uint64_t) reply->server_time;
+
+    if (reply->category == XRecordStartOfData) {
+        process_start_of_data(timestamp);
+    } else if (reply->category == XRecordEndOfData) {
+        process_end_of_data(timestamp);
+    } else if (reply->category == XRecordFromServer || reply->category == XRecordFromClient) {
+        uint8_t *data = xcb_record_enable_context_data(reply);
+        int length = xcb_record_enable_context_data_length(reply);
+        bool has_time = reply->element_header & XCB_RECORD_H_TYPE_FROM_SERVER_TIME;
+
+        int offset = 0;
+        while (offset < length) {
+            // Each element is prefixed with its own server time when requested.
+            if (has_time) {
+                if (offset + 4 > length) {
+                    break;
+                }
+
+                timestamp = (uint64_t) read_card32(data + offset, reply->client_swapped);
+                offset += 4;
+            }
+
+            // Only core device events are recorded, each is a fixed size xEvent.
+            if (offset + (int) sizeof(xEvent) > length) {
+                logger(LOG_LEVEL_WARN, "%s [%u]: Truncated XRecord reply! (%d of %d)\n",
+                        __FUNCTION__, __LINE__, offset, length);
+                break;
+            }
+
+            process_datum(timestamp, (XRecordDatum *) (data + offset));
+            offset += sizeof(xEvent);
+        }
+    } else {
+        logger(LOG_LEVEL_WARN, "%s [%u]: Unhandled X11 hook category! (%#X)\n",
+                __FUNCTION__, __LINE__, reply->category);
+    }
+}
+
+static int xrecord_alloc() {
+    int status = UIOHOOK_FAILURE;
+
+    // The data display is only used through its XCB connection from here on.
+    xcb_connection_t *connection = XGetXCBConnection(hook->data.display);
+
+    // Setup XRecord range.
+    xcb_record_client_spec_t clients = XCB_RECORD_CS_ALL_CLIENTS;
+    xcb_record_range_t range;
+    memset(&range, 0, sizeof(range));
+    get_record_range(__atomic_load_n(&event_mask, __ATOMIC_RELAXED),
+            &range.device_events.first, &range.device_events.last);
+
+    xcb_record_context_t context = xcb_generate_id(connection);
+    xcb_generic_error_t *error = xcb_request_check(connection,
+            xcb_record_create_context_checked(connection, context, XCB_RECORD_H_TYPE_FROM_SERVER_TIME, 1, 1, &clients, &range));
+    if (error == NULL) {
+        logger(LOG_LEVEL_DEBUG, "%s [%u]: xcb_record_create_context successful.\n",
+                __FUNCTION__, __LINE__);
+
+        set_record_context(context);
+
+        // Block until hook_stop() is called, each reply carries a batch of events.
+        xcb_record_enable_context_cookie_t cookie = xcb_record_enable_context(connection, context);
+        xcb_record_enable_context_reply_t *reply;
+        bool is_enabled = false, is_running = true;
+        while (is_running && (reply = xcb_record_enable_context_reply(connection, cookie, &error)) != NULL) {
+            is_enabled = true;
+            is_running = reply->category != XRecordEndOfData;
+
+            process_record_reply(reply);
+            free(reply);
+        }
+
+        if (is_enabled) {
+            status = UIOHOOK_SUCCESS;
+        } else {
+            logger(LOG_LEVEL_ERROR, "%s [%u]: xcb_record_enable_context failure! (%d)\n",
+                    __FUNCTION__, __LINE__, error != NULL ? error->error_code : 0);
+
+            // Set the exit status.
+            status = UIOHOOK_ERROR_X_RECORD_ENABLE_CONTEXT;
+        }
+
+        if (error != NULL) {
+            free(error);
+        }
+
+        // Free up the context once no other thread can use it.
+        set_record_context(0);
+        xcb_record_free_context(connection, context);
+        xcb_flush(connection);
+    } else {
+        logger(LOG_LEVEL_ERROR, "%s [%u]: xcb_record_create_context failure! (%d)\n",
+                __FUNCTION__, __LINE__, error->error_code);
+
+        free(error);
+
+        // Set the exit status.
+        status = UIOHOOK_ERROR_X_RECORD_CREATE_CONTEXT;
+    }
+
+    return status;
+}
+#else
+#ifdef USE_XRECORD_ASYNC
+// Longest wait for the end of data after hook_stop(), in milliseconds.
+#define END_OF_DATA_TIMEOUT 1000
+
+/* hook_stop() synchronizes on the control display after disabling the
+ * context, but the end of data arrives on the data connection, which may not
+ * have been read yet.  Keep reading it until the end of data was processed.
+ */
+static void wait_for_end_of_data() {
+    struct timespec start, now;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    struct pollfd fd = { .fd = ConnectionNumber(hook->data.display), .events = POLLIN };
+    for (;;) {
+        XRecordProcessReplies(hook->data.display);
+        if (hook->data.end_of_data) {
+            return;
+        }
+
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        long elapsed = (now.tv_sec - start.tv_sec) * 1000 + (now.tv_nsec - start.tv_nsec) / 1000000;
+        if (elapsed >= END_OF_DATA_TIMEOUT) {
+            break;
+        }
+
+        fd.revents = 0;
+        if ((poll(&fd, 1, (int) (END_OF_DATA_TIMEOUT - elapsed)) < 0 && errno != EINTR)
+                || (fd.revents & (POLLERR | POLLHUP))) {
+            break;
+        }
+    }
+
+    // Still pair the hook enabled event and unload what it loaded.
+    logger(LOG_LEVEL_WARN, "%s [%u]: XRecord end of data was not received!\n",
+            __FUNCTION__, __LINE__);
+    process_end_of_data(event.time);
+}
+#endif
+
 static inline int xrecord_block() {
     int status = UIOHOOK_FAILURE;
 
@@ -824,39 +1311,55 @@ static inline int xrecord_block() {
 
     #ifdef USE_XRECORD_ASYNC
     // Async requires that we loop so that our thread does not return.
-    if (XRecordEnableContextAsync(hook->data.display, context, hook_event_proc, closeure) != 0) {
-        // Time in MS to sleep the runloop.
-        int timesleep = 100;
-
-        // Allow the thread loop to block.
-        pthread_mutex_lock(&hook_xrecord_mutex);
-        running = true;
-
-        do {
-            // Unlock the mutex from the previous iteration.
-            pthread_mutex_unlock(&hook_xrecord_mutex);
-
+    int stop_fd = eventfd(0, EFD_CLOEXEC);
+
+    // hook_stop() only reads the descriptor while holding the lock.
+    pthread_mutex_lock(&hook_control_mutex);
+    hook->data.stop_fd = stop_fd;
+    pthread_mutex_unlock(&hook_control_mutex);
+    hook->data.end_of_data = false;
+
+    if (stop_fd < 0) {
+        logger(LOG_LEVEL_ERROR, "%s [%u]: eventfd failure! (%d)\n",
+                __FUNCTION__, __LINE__, errno);
+    } else if (XRecordEnableContextAsync(hook->data.display, hook->ctrl.context, hook_event_proc, closeure) != 0) {
+        struct pollfd fds[2];
+        fds[0].fd = ConnectionNumber(hook->data.display);
+        fds[0].events = POLLIN;
+        fds[1].fd = stop_fd;
+        fds[1].events = POLLIN;
+
+        for (;;) {
+            // Handle everything Xlib has already read before sleeping.
             XRecordProcessReplies(hook->data.display);
 
-            // Prevent 100% CPU utilization.
-            struct timeval tv;
-            gettimeofday(&tv, NULL);
+            // Sleep until the server sends data or hook_stop() is called.
+            fds[0].revents = 0;
+            fds[1].revents = 0;
+            if (poll(fds, 2, -1) < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
 
-            struct timespec ts;
-            ts.tv_sec = time(NULL) + timesleep / 1000;
-            ts.tv_nsec = tv.tv_usec * 1000 + 1000 * 1000 * (timesleep % 1000);
-            ts.tv_sec += ts.tv_nsec / (1000 * 1000 * 1000);
-            ts.tv_nsec %= (1000 * 1000 * 1000);
+                logger(LOG_LEVEL_ERROR, "%s [%u]: poll failure! (%d)\n",
+                        __FUNCTION__, __LINE__, errno);
+                break;
+            }
 
-            pthread_mutex_lock(&hook_xrecord_mutex);
-            pthread_cond_timedwait(&hook_xrecord_cond, &hook_xrecord_mutex, &ts);
-        } while (running);
+            if (fds[1].revents & POLLIN) {
+                wait_for_end_of_data();
+                break;
+            }
 
-        // Unlock after loop exit.
-        pthread_mutex_unlock(&hook_xrecord_mutex);
+            if (fds[0].revents & (POLLERR | POLLHUP)) {
+                logger(LOG_LEVEL_ERROR, "%s [%u]: XRecord data connection lost!\n",
+                        __FUNCTION__, __LINE__);
+                break;
+            }
+        }
 
         // Set the exit status.
-        status = NULL;
+        status = UIOHOOK_SUCCESS;
     }
     #else
     // Sync blocks until XRecordDisableContext() is called.
@@ -868,17 +1371,22 @@ static inline int xrecord_block() {
         logger(LOG_LEVEL_ERROR, "%s [%u]: XRecordEnableContext failure!\n",
             __FUNCTION__, __LINE__);
 
-        #ifdef USE_XRECORD_ASYNC
-        // Reset the running state.
-        pthread_mutex_lock(&hook_xrecord_mutex);
-        running = false;
-        pthread_mutex_unlock(&hook_xrecord_mutex);
-        #endif
-
         // Set the exit status.
         status = UIOHOOK_ERROR_X_RECORD_ENABLE_CONTEXT;
     }
 
+    #ifdef USE_XRECORD_ASYNC
+    // Hide the descriptor from hook_stop() before it is closed so a late
+    // signal cannot reach a reused descriptor.
+    pthread_mutex_lock(&hook_control_mutex);
+    hook->data.stop_fd = -1;
+    pthread_mutex_unlock(&hook_control_mutex);
+
+    if (stop_fd >= 0) {
+        close(stop_fd);
+    }
+    #endif
+
     return status;
 }
 
@@ -898,22 +1406,25 @@ static int xrecord_alloc() {
         logger(LOG_LEVEL_DEBUG, "%s [%u]: XRecordAllocRange successful.\n",
                 __FUNCTION__, __LINE__);
 
-        hook->data.range->device_events.first = KeyPress;
-        hook->data.range->device_events.last = MotionNotify;
+        get_record_range(__atomic_load_n(&event_mask, __ATOMIC_RELAXED),
+                &hook->data.range->device_events.first, &hook->data.range->device_events.last);
 
         // Note that the documentation for this function is incorrect,
         // hook->data.display should be used!
         // See: http://www.x.org/releases/X11R7.6/doc/libXtst/recordlib.txt
-        hook->ctrl.context = XRecordCreateContext(hook->data.display, XRecordFromServerTime, &clients, 1, &hook->data.range, 1);
-        if (hook->ctrl.context != 0) {
+        XRecordContext context = XRecordCreateContext(hook->data.display, XRecordFromServerTime, &clients, 1, &hook->data.range, 1);
+        if (context != 0) {
             logger(LOG_LEVEL_DEBUG, "%s [%u]: XRecordCreateContext successful.\n",
                     __FUNCTION__, __LINE__);
 
+            set_record_context(context);
+
             // Block until hook_stop() is called.
             status = xrecord_block();
 
-            // Free up the context if it was set.
-            XRecordFreeContext(hook->data.display, hook->ctrl.context);
+            // Free up the context once no other thread can use it.
+            set_record_context(0);
+            XRecordFreeContext(hook->data.display, context);
         } else {
             logger(LOG_LEVEL_ERROR, "%s [%u]: XRecordCreateContext failure!\n",
                     __FUNCTION__, __LINE__);
@@ -934,6 +1445,7 @@ static int xrecord_alloc() {
 
     return status;
 }
+#endif
 
 static int xrecord_query() {
     int status = UIOHOOK_FAILURE;
@@ -955,6 +1467,80 @@ static int xrecord_query() {
     return status;
 }
 
+// Prepare the keyboard state on the control display.
+static void initialize_input() {
+    #if defined(USE_XKB_COMMON)
+    // Open XCB Connection
+    hook->input.connection = XGetXCBConnection(hook->ctrl.display);
+    int xcb_status = xcb_connection_has_error(hook->input.connection);
+    if (xcb_status <= 0) {
+        // Initialize xkbcommon context.
+        struct xkb_context *context = xkb_context_new(XKB_CONTEXT_NO_FLAGS);
+
+        if (context != NULL) {
+            hook->input.context = xkb_context_ref(context);
+        } else {
+            logger(LOG_LEVEL_ERROR, "%s [%u]: xkb_context_new failure!\n",
+                    __FUNCTION__, __LINE__);
+        }
+    } else {
+        logger(LOG_LEVEL_ERROR, "%s [%u]: xcb_connect failure! (%d)\n",
+                __FUNCTION__, __LINE__, xcb_status);
+    }
+    #endif
+
+    #ifdef USE_XKB_COMMON
+    #ifdef USE_XKB_STATE_EVENTS
+    // Select notifications before the state is read so no change is missed.
+    if (select_xkb_events()) {
+        logger(LOG_LEVEL_DEBUG, "%s [%u]: Selected XKB keymap notifications.\n",
+                __FUNCTION__, __LINE__);
+    } else {
+        logger(LOG_LEVEL_WARN, "%s [%u]: Failed to select XKB keymap notifications!\n",
+                __FUNCTION__, __LINE__);
+    }
+    #endif
+
+    state = create_xkb_state(hook->input.context, hook->input.connection);
+
+    // Locked modifiers recorded with key events set the lock masks.
+    hook->input.num_lock_mask = XkbKeysymToModifiers(hook->ctrl.display, XK_Num_Lock);
+    hook->input.scroll_lock_mask = XkbKeysymToModifiers(hook->ctrl.display, XK_Scroll_Lock);
+    #elif defined(USE_XKB_INDICATOR_EVENTS)
+    // Select indicator notifications before the initial lock state is read
+    // so that no change can be missed in between.
+    if (select_indicator_events()) {
+        logger(LOG_LEVEL_DEBUG, "%s [%u]: Selected XKB indicator state notifications.\n",
+                __FUNCTION__, __LINE__);
+
+        // Locked modifiers recorded with key events are applied without waiting for a notification.
+        hook->input.num_lock_mask = XkbKeysymToModifiers(hook->ctrl.display, XK_Num_Lock);
+        hook->input.scroll_lock_mask = XkbKeysymToModifiers(hook->ctrl.display, XK_Scroll_Lock);
+    } else {
+        logger(LOG_LEVEL_WARN, "%s [%u]: Failed to select XKB indicator state notifications!\n",
+                __FUNCTION__, __LINE__);
+    }
+    #endif
+
+    // Initialize starting modifiers.
+    initialize_modifiers();
+}
+
+// Release the keyboard state created by initialize_input().
+static void release_input() {
+    #ifdef USE_XKB_COMMON
+    if (state != NULL) {
+        destroy_xkb_state(state);
+        state = NULL;
+    }
+
+    if (hook->input.context != NULL) {
+        xkb_context_unref(hook->input.context);
+        hook->input.context = NULL;
+    }
+    #endif
+}
+
 static int xrecord_start() {
     int status = UIOHOOK_FAILURE;
 
@@ -977,45 +1563,11 @@ static int xrecord_start() {
                     __FUNCTION__, __LINE__);
         }
 
-        #if defined(USE_XKB_COMMON)
-        // Open XCB Connection
-        hook->input.connection = XGetXCBConnection(hook->ctrl.display);
-        int xcb_status = xcb_connection_has_error(hook->input.connection);
-        if (xcb_status <= 0) {
-            // Initialize xkbcommon context.
-            struct xkb_context *context = xkb_context_new(XKB_CONTEXT_NO_FLAGS);
-
-            if (context != NULL) {
-                hook->input.context = xkb_context_ref(context);
-            } else {
-                logger(LOG_LEVEL_ERROR, "%s [%u]: xkb_context_new failure!\n",
-                        __FUNCTION__, __LINE__);
-            }
-        } else {
-            logger(LOG_LEVEL_ERROR, "%s [%u]: xcb_connect failure! (%d)\n",
-                    __FUNCTION__, __LINE__, xcb_status);
-        }
-        #endif
-
-        #ifdef USE_XKB_COMMON
-        state = create_xkb_state(hook->input.context, hook->input.connection);
-        #endif
-
-        // Initialize starting modifiers.
-        initialize_modifiers();
+        initialize_input();
 
         status = xrecord_query();
 
-        #ifdef USE_XKB_COMMON
-        if (state != NULL) {
-            destroy_xkb_state(state);
-        }
-
-        if (hook->input.context != NULL) {
-            xkb_context_unref(hook->input.context);
-            hook->input.context = NULL;
-        }
-        #endif
+        release_input();
     } else {
         logger(LOG_LEVEL_ERROR, "%s [%u]: XOpenDisplay failure!\n",
                 __FUNCTION__, __LINE__);
@@ -1038,27 +1590,93 @@ static int xrecord_start() {
     return status;
 }
 
-UIOHOOK_API int hook_run() {
-    // Hook data for future cleanup.
-    hook = malloc(sizeof(hook_info));
-    if (hook == NULL) {
+// Allocate and reset the hook structure.
+static hook_info * create_hook_info() {
+    hook_info *info = malloc(sizeof(hook_info));
+    if (info == NULL) {
         logger(LOG_LEVEL_ERROR, "%s [%u]: Failed to allocate memory for hook structure!\n",
               __FUNCTION__, __LINE__);
 
+        return NULL;
+    }
+
+    info->data.display = NULL;
+    info->ctrl.display = NULL;
+    info->ctrl.context = 0;
+
+    #ifdef USE_XKB_COMMON
+    info->input.connection = NULL;
+    info->input.context = NULL;
+    #endif
+
+    #ifdef USE_XRECORD_ASYNC
+    info->data.stop_fd = -1;
+    #endif
+
+    info->input.mask = 0x0000;
+    info->input.mouse.is_dragged = false;
+    info->input.mouse.click.count = 0;
+    info->input.mouse.click.time = 0;
+    info->input.mouse.click.button = MOUSE_NOBUTTON;
+
+    return info;
+}
+
+#ifdef USE_SYNTHETIC_HOOK
+int create_synthetic_hook() {
+    hook = create_hook_info();
+    if (hook == NULL) {
         return UIOHOOK_ERROR_OUT_OF_MEMORY;
     }
 
-    hook->input.mask = 0x0000;
-    hook->input.mouse.is_dragged = false;
-    hook->input.mouse.click.count = 0;
-    hook->input.mouse.click.time = 0;
-    hook->input.mouse.click.button = MOUSE_NOBUTTON;
+    hook->ctrl.display = XOpenDisplay(NULL);
+    if (hook->ctrl.display == NULL) {
+        logger(LOG_LEVEL_ERROR, "%s [%u]: XOpenDisplay failure!\n",
+                __FUNCTION__, __LINE__);
+
+        free(hook);
+        hook = NULL;
+
+        return UIOHOOK_ERROR_X_OPEN_DISPLAY;
+    }
+
+    initialize_input();
+    process_start_of_data(0);
+
+    return UIOHOOK_SUCCESS;
+}
+
+void destroy_synthetic_hook() {
+    if (hook != NULL) {
+        process_end_of_data(0);
+        release_input();
+
+        XCloseDisplay(hook->ctrl.display);
+        free(hook);
+        hook = NULL;
+    }
+}
+#endif
+
+UIOHOOK_API int hook_run() {
+    // Hook data for future cleanup.
+    hook_info *info = create_hook_info();
+    if (info == NULL) {
+        return UIOHOOK_ERROR_OUT_OF_MEMORY;
+    }
+
+    pthread_mutex_lock(&hook_control_mutex);
+    hook = info;
+    pthread_mutex_unlock(&hook_control_mutex);
 
     int status = xrecord_start();
 
     // Free data associated with this hook.
-    free(hook);
+    pthread_mutex_lock(&hook_control_mutex);
     hook = NULL;
+    pthread_mutex_unlock(&hook_control_mutex);
+
+    free(info);
 
     logger(LOG_LEVEL_DEBUG, "%s [%u]: Something, something, something, complete.\n",
             __FUNCTION__, __LINE__);
@@ -1066,28 +1684,231 @@ UIOHOOK_API int hook_run() {
     return status;
 }
 
+UIOHOOK_API int hook_set_event_mask(uint32_t mask) {
+    int status = UIOHOOK_SUCCESS;
+
+    // Hold the lock so the hook thread cannot free the context while it is updated.
+    pthread_mutex_lock(&hook_control_mutex);
+
+    __atomic_store_n(&event_mask, mask, __ATOMIC_RELAXED);
+
+    // Replace the intercepted ranges of a running hook in place.
+    if (hook != NULL && hook->ctrl.context != 0 && hook->ctrl.display != NULL) {
+        XRecordRange *range = XRecordAllocRange();
+        if (range != NULL) {
+            get_record_range(mask, &range->device_events.first, &range->device_events.last);
+
+            XRecordClientSpec clients = XRecordAllClients;
+            if (XRecordRegisterClients(hook->ctrl.display, hook->ctrl.context, XRecordFromServerTime, &clients, 1, &range, 1) != 0) {
+                XSync(hook->ctrl.display, False);
+
+                logger(LOG_LEVEL_DEBUG, "%s [%u]: Recording core events %u through %u.\n",
+                        __FUNCTION__, __LINE__, range->device_events.first, range->device_events.last);
+            } else {
+                logger(LOG_LEVEL_ERROR, "%s [%u]: XRecordRegisterClients failure!\n",
+                        __FUNCTION__, __LINE__);
+
+                status = UIOHOOK_FAILURE;
+            }
+
+            XFree(range);
+        } else {
+            logger(LOG_LEVEL_ERROR, "%s [%u]: XRecordAllocRange failure!\n",
+                    __FUNCTION__, __LINE__);
+
+            status = UIOHOOK_ERROR_X_RECORD_ALLOC_RANGE;
+        }
+    }
+
+    pthread_mutex_unlock(&hook_control_mutex);
+
+    return status;
+}
+
+// Dispatch queued events until the hook has stopped and the queue is empty.
+static void *dispatch_thread_proc(void *arg) {
+    dispatch_queue *dispatch = (dispatch_queue *) arg;
+    uiohook_event copy;
+
+    while (dispatch_queue_pop(dispatch, &copy, true)) {
+        if (dispatcher != NULL) {
+            logger(LOG_LEVEL_DEBUG, "%s [%u]: Dispatching event type %u.\n",
+                    __FUNCTION__, __LINE__, copy.type);
+
+            dispatcher(&copy);
+        }
+    }
+
+    return NULL;
+}
+
+UIOHOOK_API int hook_run_async(size_t capacity, queue_overflow overflow) {
+    dispatch_queue *dispatch = create_dispatch_queue(capacity);
+    if (dispatch == NULL) {
+        return UIOHOOK_ERROR_OUT_OF_MEMORY;
+    }
+
+    __atomic_store_n(&queue_stats.enqueued, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&queue_stats.dropped, 0, __ATOMIC_RELAXED);
+
+    pthread_t dispatch_thread;
+    if (pthread_create(&dispatch_thread, NULL, dispatch_thread_proc, dispatch) != 0) {
+        logger(LOG_LEVEL_ERROR, "%s [%u]: Failed to create dispatch thread!\n",
+                __FUNCTION__, __LINE__);
+
+        destroy_dispatch_queue(dispatch);
+        return UIOHOOK_ERROR_CREATE_THREAD;
+    }
+
+    queue_block = overflow == QUEUE_OVERFLOW_BLOCK;
+    queue = dispatch;
+
+    int status = hook_run();
+
+    // The hook thread is done producing, let the dispatch thread drain and exit.
+    queue = NULL;
+    dispatch_queue_wake(dispatch);
+    pthread_join(dispatch_thread, NULL);
+
+    destroy_dispatch_queue(dispatch);
+
+    logger(LOG_LEVEL_DEBUG, "%s [%u]: Dispatched %" PRIu64 " events, dropped %" PRIu64 ".\n",
+            __FUNCTION__, __LINE__, queue_stats.enqueued, queue_stats.dropped);
+
+    return status;
+}
+
+UIOHOOK_API int hook_open_event_fd(size_t capacity, queue_overflow overflow) {
+    #ifdef __linux__
+    if (__atomic_load_n(&fd_queue, __ATOMIC_ACQUIRE) != NULL) {
+        logger(LOG_LEVEL_ERROR, "%s [%u]: Event file descriptor is already open!\n",
+                __FUNCTION__, __LINE__);
+
+        return -1;
+    }
+
+    dispatch_queue *reader = create_dispatch_queue(capacity);
+    if (reader == NULL) {
+        return -1;
+    }
+
+    int fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (fd < 0) {
+        logger(LOG_LEVEL_ERROR, "%s [%u]: eventfd failure! (%d)\n",
+                __FUNCTION__, __LINE__, errno);
+
+        destroy_dispatch_queue(reader);
+        return -1;
+    }
+
+    __atomic_store_n(&queue_stats.enqueued, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&queue_stats.dropped, 0, __ATOMIC_RELAXED);
+
+    event_fd = fd;
+    event_fd_signaled = false;
+    fd_queue_block = overflow == QUEUE_OVERFLOW_BLOCK;
+    __atomic_store_n(&fd_queue, reader, __ATOMIC_RELEASE);
+
+    logger(LOG_LEVEL_DEBUG, "%s [%u]: Opened event file descriptor %d for %zu events.\n",
+            __FUNCTION__, __LINE__, fd, dispatch_queue_capacity(reader));
+
+    return fd;
+    #else
+    logger(LOG_LEVEL_ERROR, "%s [%u]: Event file descriptors require eventfd, which is only available on Linux!\n",
+            __FUNCTION__, __LINE__);
+
+    return -1;
+    #endif
+}
+
+UIOHOOK_API size_t hook_read_events(uiohook_event *buffer, size_t max) {
+    dispatch_queue *reader = __atomic_load_n(&fd_queue, __ATOMIC_ACQUIRE);
+    if (reader == NULL || max == 0) {
+        return 0;
+    }
+
+    /* Reset the counter before clearing the flag.  An event pushed after the
+     * flag is cleared signals again, anything pushed before is drained below.
+     */
+    uint64_t value;
+    while (read(event_fd, &value, sizeof(value)) < 0 && errno == EINTR);
+    __atomic_store_n(&event_fd_signaled, false, __ATOMIC_SEQ_CST);
+
+    size_t count = 0;
+    while (count < max && dispatch_queue_pop(reader, &buffer[count], false)) {
+        count++;
+    }
+
+    // Keep the descriptor readable if the buffer was too small to drain the queue.
+    if (count == max && !__atomic_exchange_n(&event_fd_signaled, true, __ATOMIC_SEQ_CST)) {
+        signal_event_fd();
+    }
+
+    return count;
+}
+
+UIOHOOK_API int hook_close_event_fd() {
+    int status = UIOHOOK_SUCCESS;
+
+    // The hook thread pushes to the queue without a lock, so it must not be running.
+    // Holding the lock also keeps hook_run() from starting until the queue is gone.
+    pthread_mutex_lock(&hook_control_mutex);
+
+    if (hook != NULL) {
+        logger(LOG_LEVEL_ERROR, "%s [%u]: Event file descriptor can not be closed while the hook is running!\n",
+                __FUNCTION__, __LINE__);
+
+        status = UIOHOOK_FAILURE;
+    } else {
+        dispatch_queue *reader = __atomic_exchange_n(&fd_queue, NULL, __ATOMIC_ACQ_REL);
+        if (reader != NULL) {
+            close(event_fd);
+            event_fd = -1;
+
+            destroy_dispatch_queue(reader);
+
+            logger(LOG_LEVEL_DEBUG, "%s [%u]: Closed event file descriptor, read %" PRIu64 " events, dropped %" PRIu64 ".\n",
+                    __FUNCTION__, __LINE__, queue_stats.enqueued, queue_stats.dropped);
+        }
+    }
+
+    pthread_mutex_unlock(&hook_control_mutex);
+
+    return status;
+}
+
+UIOHOOK_API void hook_get_dispatch_stats(dispatch_stats *stats) {
+    stats->enqueued = __atomic_load_n(&queue_stats.enqueued, __ATOMIC_RELAXED);
+    stats->dropped = __atomic_load_n(&queue_stats.dropped, __ATOMIC_RELAXED);
+}
+
 UIOHOOK_API int hook_stop() {
     int status = UIOHOOK_FAILURE;
 
-    if (hook != NULL && hook->ctrl.display != NULL && hook->ctrl.context != 0) {
+    // Hold the lock so the hook thread cannot free the context while it is disabled.
+    pthread_mutex_lock(&hook_control_mutex);
+
+    if (hook != NULL && hook->ctrl.context != 0 && hook->ctrl.display != NULL) {
         // We need to make sure the context is still valid.
         XRecordState *state = malloc(sizeof(XRecordState));
         if (state != NULL) {
             if (XRecordGetContext(hook->ctrl.display, hook->ctrl.context, &state) != 0) {
                 // Try to exit the thread naturally.
                 if (state->enabled && XRecordDisableContext(hook->ctrl.display, hook->ctrl.context) != 0) {
-                    #ifdef USE_XRECORD_ASYNC
-                    pthread_mutex_lock(&hook_xrecord_mutex);
-                    running = false;
-                    pthread_cond_signal(&hook_xrecord_cond);
-                    pthread_mutex_unlock(&hook_xrecord_mutex);
-                    #endif
-
                     // See Bug 42356 for more information.
                     // https://bugs.freedesktop.org/show_bug.cgi?id=42356#c4
                     //XFlush(hook->ctrl.display);
                     XSync(hook->ctrl.display, False);
 
+                    #ifdef USE_XRECORD_ASYNC
+                    // Wake the async loop.
+                    uint64_t value = 1;
+                    if (hook->data.stop_fd >= 0 && write(hook->data.stop_fd, &value, sizeof(value)) != sizeof(value)) {
+                        logger(LOG_LEVEL_WARN, "%s [%u]: Failed to signal the XRecord loop! (%d)\n",
+                                __FUNCTION__, __LINE__, errno);
+                    }
+                    #endif
+
                     status = UIOHOOK_SUCCESS;
                 }
             } else {
@@ -1106,6 +1927,8 @@ UIOHOOK_API int hook_stop() {
         }
     }
 
+    pthread_mutex_unlock(&hook_control_mutex);
+
     logger(LOG_LEVEL_DEBUG, "%s [%u]: Status: %#X.\n",
             __FUNCTION__, __LINE__, status);
 
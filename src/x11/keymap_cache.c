@@ -0,0 +1,214 @@
+/* libUIOHook: Cross-platform keyboard and mouse hooking from userland.
+ * Copyright (C) 2006-2023 Alexander Barker.  All Rights Reserved.
+ * https://github.com/kwhat/libuiohook/
+ *
+ * libUIOHook is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libUIOHook is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <uiohook.h>
+
+#include "keymap_cache.h"
+#include "logger.h"
+
+// "UIOHKMAP" followed by the format version.
+#define KEYMAP_CACHE_MAGIC   0x50414D4B484F4955ULL
+#define KEYMAP_CACHE_VERSION 1
+
+// Refuse anything larger, compiled keymaps are well under a megabyte.
+#define KEYMAP_CACHE_MAX_SIZE (16 * 1024 * 1024)
+
+/* Every cache file starts with this header in host byte order.  The cache is
+ * only ever read by the library build that wrote it on the same machine.
+ */
+typedef struct _keymap_cache_header {
+    uint64_t magic;
+    uint32_t version;
+    uint32_t reserved;
+    uint64_t hash;
+    uint64_t size;
+} keymap_cache_header;
+
+uint64_t keymap_cache_hash(uint64_t hash, const void *data, size_t size) {
+    const unsigned char *bytes = (const unsigned char *) data;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= 0x00000100000001B3ULL;
+    }
+
+    return hash;
+}
+
+/* Build the path of the cache file for key in $XDG_CACHE_HOME/libuiohook or
+ * ~/.cache/libuiohook, creating the directories when create is true.
+ */
+static bool cache_path(uint64_t key, bool create, char *path, size_t size) {
+    int length;
+    const char *base = getenv("XDG_CACHE_HOME");
+    if (base != NULL && base[0] == '/') {
+        length = snprintf(path, size, "%s", base);
+    } else if ((base = getenv("HOME")) != NULL && base[0] == '/') {
+        length = snprintf(path, size, "%s/.cache", base);
+    } else {
+        return false;
+    }
+
+    if (length < 0 || (size_t) length >= size) {
+        return false;
+    }
+
+    if (create && mkdir(path, 0700) != 0 && errno != EEXIST) {
+        return false;
+    }
+
+    size_t used = (size_t) length;
+    length = snprintf(path + used, size - used, "/libuiohook");
+    if (length < 0 || (size_t) length >= size - used) {
+        return false;
+    }
+
+    if (create && mkdir(path, 0700) != 0 && errno != EEXIST) {
+        return false;
+    }
+
+    used += (size_t) length;
+    length = snprintf(path + used, size - used, "/keymap-%016llx.cache", (unsigned long long) key);
+
+    return length >= 0 && (size_t) length < size - used;
+}
+
+// Read exactly size bytes unless the file ends first.
+static bool read_fully(int fd, void *buffer, size_t size) {
+    unsigned char *bytes = (unsigned char *) buffer;
+    while (size > 0) {
+        ssize_t count = read(fd, bytes, size);
+        if (count < 0 && errno == EINTR) {
+            continue;
+        } else if (count <= 0) {
+            return false;
+        }
+
+        bytes += count;
+        size -= (size_t) count;
+    }
+
+    return true;
+}
+
+static bool write_fully(int fd, const void *buffer, size_t size) {
+    const unsigned char *bytes = (const unsigned char *) buffer;
+    while (size > 0) {
+        ssize_t count = write(fd, bytes, size);
+        if (count < 0 && errno == EINTR) {
+            continue;
+        } else if (count <= 0) {
+            return false;
+        }
+
+        bytes += count;
+        size -= (size_t) count;
+    }
+
+    return true;
+}
+
+void * keymap_cache_read(uint64_t key, uint64_t hash, size_t *size) {
+    char path[PATH_MAX];
+    if (!cache_path(key, false, path, sizeof(path))) {
+        return NULL;
+    }
+
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        logger(LOG_LEVEL_DEBUG, "%s [%u]: No keymap cache at %s.\n",
+                __FUNCTION__, __LINE__, path);
+        return NULL;
+    }
+
+    void *data = NULL;
+    keymap_cache_header header;
+    if (read_fully(fd, &header, sizeof(header))
+            && header.magic == KEYMAP_CACHE_MAGIC && header.version == KEYMAP_CACHE_VERSION
+            && header.hash == hash && header.size > 0 && header.size <= KEYMAP_CACHE_MAX_SIZE) {
+        data = malloc((size_t) header.size);
+        if (data != NULL && read_fully(fd, data, (size_t) header.size)) {
+            *size = (size_t) header.size;
+        } else {
+            free(data);
+            data = NULL;
+        }
+    }
+    close(fd);
+
+    if (data == NULL) {
+        logger(LOG_LEVEL_DEBUG, "%s [%u]: Ignoring stale keymap cache at %s.\n",
+                __FUNCTION__, __LINE__, path);
+    }
+
+    return data;
+}
+
+bool keymap_cache_write(uint64_t key, uint64_t hash, const void *data, size_t size) {
+    char path[PATH_MAX], temp[PATH_MAX];
+    if (size == 0 || size > KEYMAP_CACHE_MAX_SIZE || !cache_path(key, true, path, sizeof(path))) {
+        return false;
+    }
+
+    int length = snprintf(temp, sizeof(temp), "%s.XXXXXX", path);
+    if (length < 0 || (size_t) length >= sizeof(temp)) {
+        return false;
+    }
+
+    int fd = mkstemp(temp);
+    if (fd < 0) {
+        logger(LOG_LEVEL_WARN, "%s [%u]: Failed to create %s! (%i)\n",
+                __FUNCTION__, __LINE__, temp, errno);
+        return false;
+    }
+
+    keymap_cache_header header = {
+        .magic = KEYMAP_CACHE_MAGIC,
+        .version = KEYMAP_CACHE_VERSION,
+        .reserved = 0,
+        .hash = hash,
+        .size = size
+    };
+
+    bool written = write_fully(fd, &header, sizeof(header)) && write_fully(fd, data, size);
+    if (close(fd) != 0) {
+        written = false;
+    }
+
+    if (!written || rename(temp, path) != 0) {
+        logger(LOG_LEVEL_WARN, "%s [%u]: Failed to write the keymap cache %s! (%i)\n",
+                __FUNCTION__, __LINE__, path, errno);
+
+        unlink(temp);
+        return false;
+    }
+
+    logger(LOG_LEVEL_DEBUG, "%s [%u]: Wrote %zu bytes to the keymap cache %s.\n",
+            __FUNCTION__, __LINE__, size, path);
+
+    return true;
+}
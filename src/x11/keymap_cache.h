@@ -0,0 +1,44 @@
+/* libUIOHook: Cross-platform keyboard and mouse hooking from userland.
+ * Copyright (C) 2006-2023 Alexander Barker.  All Rights Reserved.
+ * https://github.com/kwhat/libuiohook/
+ *
+ * libUIOHook is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libUIOHook is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _included_keymap_cache
+#define _included_keymap_cache
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Starting value for keymap_cache_hash().
+#define KEYMAP_CACHE_HASH_INIT 0xCBF29CE484222325ULL
+
+/* Fold data into a 64-bit FNV-1a hash, starting from KEYMAP_CACHE_HASH_INIT.
+ */
+extern uint64_t keymap_cache_hash(uint64_t hash, const void *data, size_t size);
+
+/* Read the cache entry stored under key.  Returns a buffer with the payload,
+ * to be released with free(), if the entry exists and was written for the
+ * same hash, otherwise NULL.
+ */
+extern void * keymap_cache_read(uint64_t key, uint64_t hash, size_t *size);
+
+/* Store a payload under key, replacing any earlier entry.  The entry is
+ * written to a temporary file and renamed so readers never see part of it.
+ */
+extern bool keymap_cache_write(uint64_t key, uint64_t hash, const void *data, size_t size);
+
+#endif
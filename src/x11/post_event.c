@@ -16,11 +16,16 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <errno.h>
+#include <pthread.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <time.h>
 #include <uiohook.h>
 #include <X11/Xlib.h>
+#include <X11/keysym.h>
 #include <X11/Xutil.h>
 #ifdef USE_XTEST
 #include <X11/extensions/XTest.h>
@@ -31,9 +36,90 @@
 
 #ifndef USE_XTEST
 static long current_modifier_mask = NoEventMask;
+
+// Window key events were last selected on, see select_key_events().
+static Window selected_window = None;
+
+// Result of the last find_pointer_window() walk and what it depends on.
+static struct {
+    bool valid;
+    int x, y;
+    unsigned long generation;
+    XButtonEvent event;
+} pointer_window_cache;
+
+// Window with the input focus, normally without a server round trip.
+static Window get_target_window() {
+    Window window = get_focus_window();
+    if (window == None) {
+        // The settings thread has not seen the focus yet.
+        int revert;
+        XGetInputFocus(helper_disp, &window, &revert);
+    }
+
+    return window;
+}
+
+// Select key events on a new target window only once.
+static void select_key_events(Window window) {
+    if (window != selected_window && window != None && window != PointerRoot) {
+        XSelectInput(helper_disp, window, KeyPressMask | KeyReleaseMask);
+        selected_window = window;
+    }
+}
+
+/* Walk down the window tree to the window under the pointer and fill in the
+ * window, root and coordinates of the event.  The walk costs one round trip
+ * per level, so the result is reused for further events at the same position
+ * until the focus generation changes, which also happens when a top level
+ * window is reconfigured or a cached window is found to be destroyed.
+ */
+static void find_pointer_window(XButtonEvent *btn_event) {
+    int x = btn_event->x, y = btn_event->y;
+    unsigned long generation = get_focus_generation();
+
+    if (pointer_window_cache.valid && pointer_window_cache.x == x && pointer_window_cache.y == y
+            && pointer_window_cache.generation == generation) {
+        btn_event->window = pointer_window_cache.event.window;
+        btn_event->root = pointer_window_cache.event.root;
+        btn_event->subwindow = None;
+        btn_event->x_root = pointer_window_cache.event.x_root;
+        btn_event->y_root = pointer_window_cache.event.y_root;
+        btn_event->x = pointer_window_cache.event.x;
+        btn_event->y = pointer_window_cache.event.y;
+        btn_event->state = pointer_window_cache.event.state;
+        return;
+    }
+
+    // FIXME This is still not working correctly, clicking on other windows does not yield focus.
+    while (btn_event->subwindow != None)
+    {
+        btn_event->window = btn_event->subwindow;
+
+        // Left unchanged if the window was destroyed, which ends the walk.
+        btn_event->subwindow = None;
+        XQueryPointer (
+            btn_event->display,
+            btn_event->window,
+            &btn_event->root,
+            &btn_event->subwindow,
+            &btn_event->x_root,
+            &btn_event->y_root,
+            &btn_event->x,
+            &btn_event->y,
+            &btn_event->state
+        );
+    }
+
+    pointer_window_cache.valid = true;
+    pointer_window_cache.x = x;
+    pointer_window_cache.y = y;
+    pointer_window_cache.generation = generation;
+    pointer_window_cache.event = *btn_event;
+}
 #endif
 
-static int post_key_event(uiohook_event * const event) {
+static int post_key_event(const uiohook_event * const event) {
     KeyCode keycode = scancode_to_keycode(event->data.keyboard.keycode);
     if (keycode == 0x0000) {
         logger(LOG_LEVEL_WARN, "%s [%u]: Unable to lookup scancode: %li\n",
@@ -66,8 +152,7 @@ static int post_key_event(uiohook_event * const event) {
         .keycode = keycode
     };
 
-    int revert;
-    XGetInputFocus(helper_disp, &(key_event.window), &revert);
+    key_event.window = get_target_window();
     #endif
 
     if (event->type == EVENT_KEY_PRESSED) {
@@ -142,7 +227,7 @@ static int post_key_event(uiohook_event * const event) {
         return UIOHOOK_FAILURE;
     }
     #else
-    XSelectInput(helper_disp, key_event.window, KeyPressMask | KeyReleaseMask);
+    select_key_events(key_event.window);
     if (XSendEvent(helper_disp, key_event.window, False, event_mask, (XEvent *) &key_event) == 0) {
         logger(LOG_LEVEL_ERROR, "%s [%u]: XSendEvent() failed!\n",
             __FUNCTION__, __LINE__, event->type);
@@ -153,7 +238,7 @@ static int post_key_event(uiohook_event * const event) {
     return UIOHOOK_SUCCESS;
 }
 
-static int post_mouse_button_event(uiohook_event * const event) {
+static int post_mouse_button_event(const uiohook_event * const event) {
     XButtonEvent btn_event = {
         .serial = 0,
         .send_event = False,
@@ -184,22 +269,7 @@ static int post_mouse_button_event(uiohook_event * const event) {
     #endif
 
     #ifndef USE_XTEST
-    // FIXME This is still not working correctly, clicking on other windows does not yield focus.
-    while (btn_event.subwindow != None)
-    {
-        btn_event.window = btn_event.subwindow;
-        XQueryPointer (
-            btn_event.display,
-            btn_event.window,
-            &btn_event.root,
-            &btn_event.subwindow,
-            &btn_event.x_root,
-            &btn_event.y_root,
-            &btn_event.x,
-            &btn_event.y,
-            &btn_event.state
-        );
-    }
+    find_pointer_window(&btn_event);
     #endif
 
     switch (event->type) {
@@ -278,7 +348,7 @@ static int post_mouse_button_event(uiohook_event * const event) {
     return UIOHOOK_SUCCESS;
 }
 
-static int post_mouse_wheel_event(uiohook_event * const event) {
+static int post_mouse_wheel_event(const uiohook_event * const event) {
     XButtonEvent btn_event = {
         .serial = 0,
         .send_event = False,
@@ -301,22 +371,7 @@ static int post_mouse_wheel_event(uiohook_event * const event) {
     };
 
     #ifndef USE_XTEST
-    // FIXME This is still not working correctly, clicking on other windows does not yield focus.
-    while (btn_event.subwindow != None)
-    {
-        btn_event.window = btn_event.subwindow;
-        XQueryPointer (
-            btn_event.display,
-            btn_event.window,
-            &btn_event.root,
-            &btn_event.subwindow,
-            &btn_event.x_root,
-            &btn_event.y_root,
-            &btn_event.x,
-            &btn_event.y,
-            &btn_event.state
-        );
-    }
+    find_pointer_window(&btn_event);
     #endif
 
     // Wheel events should be the same as click events on X11.
@@ -344,7 +399,7 @@ static int post_mouse_wheel_event(uiohook_event * const event) {
     return UIOHOOK_SUCCESS;
 }
 
-static void post_mouse_motion_event(uiohook_event * const event) {
+static void post_mouse_motion_event(const uiohook_event * const event) {
     #ifdef USE_XTEST
     XTestFakeMotionEvent(helper_disp, -1, event->data.mouse.x, event->data.mouse.y, 0);
     #else
@@ -372,41 +427,45 @@ static void post_mouse_motion_event(uiohook_event * const event) {
         .same_screen = True
     };
 
-    int revert;
-    XGetInputFocus(helper_disp, &(mov_event.window), &revert);
+    mov_event.window = get_target_window();
 
     XSendEvent(helper_disp, mov_event.window, False, mov_event.state, (XEvent *) &mov_event);
     #endif
 }
 
-// TODO This should return a status code, UIOHOOK_SUCCESS or otherwise.
-UIOHOOK_API void hook_post_event(uiohook_event * const event) {
-    if (helper_disp == NULL) {
-        logger(LOG_LEVEL_ERROR, "%s [%u]: XDisplay helper_disp is unavailable!\n",
-            __FUNCTION__, __LINE__);
-        return; // UIOHOOK_ERROR_X_OPEN_DISPLAY
-    }
+// Open what posting needs on first use.
+static void load_post_display() {
+    #ifdef USE_XTEST
+    load_helper_display();
+    #else
+    // Events are sent to the focus window followed by the settings thread.
+    load_settings_thread();
+    #endif
+}
 
-    XLockDisplay(helper_disp);
+// Queue the requests for a single event, the display must be locked.
+static int post_event(const uiohook_event * const event) {
+    int status = UIOHOOK_FAILURE;
 
     switch (event->type) {
         case EVENT_KEY_PRESSED:
         case EVENT_KEY_RELEASED:
-            post_key_event(event);
+            status = post_key_event(event);
             break;
 
         case EVENT_MOUSE_PRESSED:
         case EVENT_MOUSE_RELEASED:
-            post_mouse_button_event(event);
+            status = post_mouse_button_event(event);
             break;
 
         case EVENT_MOUSE_WHEEL:
-            post_mouse_wheel_event(event);
+            status = post_mouse_wheel_event(event);
             break;
 
         case EVENT_MOUSE_MOVED:
         case EVENT_MOUSE_DRAGGED:
             post_mouse_motion_event(event);
+            status = UIOHOOK_SUCCESS;
             break;
 
         case EVENT_KEY_TYPED:
@@ -421,7 +480,425 @@ UIOHOOK_API void hook_post_event(uiohook_event * const event) {
             break;
     }
 
+    return status;
+}
+
+// TODO This should return a status code, UIOHOOK_SUCCESS or otherwise.
+UIOHOOK_API void hook_post_event(uiohook_event * const event) {
+    load_post_display();
+
+    if (helper_disp == NULL) {
+        logger(LOG_LEVEL_ERROR, "%s [%u]: XDisplay helper_disp is unavailable!\n",
+            __FUNCTION__, __LINE__);
+        return; // UIOHOOK_ERROR_X_OPEN_DISPLAY
+    }
+
+    XLockDisplay(helper_disp);
+
+    #ifndef USE_XTEST
+    unsigned long window_errors = get_window_errors();
+    #endif
+
+    post_event(event);
+
     // Don't forget to flush!
     XSync(helper_disp, True);
+
+    #ifndef USE_XTEST
+    if (get_window_errors() != window_errors) {
+        // A cached window was destroyed, the caches are reset so look it up again.
+        logger(LOG_LEVEL_DEBUG, "%s [%u]: Target window was destroyed, posting again.\n",
+                __FUNCTION__, __LINE__);
+
+        post_event(event);
+        XSync(helper_disp, True);
+    }
+    #endif
+
+    XUnlockDisplay(helper_disp);
+}
+
+UIOHOOK_API size_t hook_post_events(const uiohook_event *events, size_t count, unsigned int flags) {
+    load_post_display();
+
+    if (helper_disp == NULL) {
+        logger(LOG_LEVEL_ERROR, "%s [%u]: XDisplay helper_disp is unavailable!\n",
+            __FUNCTION__, __LINE__);
+        return 0;
+    }
+
+    size_t posted = 0;
+
+    // All requests go out in one stream with at most one round trip at the end.
+    XLockDisplay(helper_disp);
+
+    #ifndef USE_XTEST
+    unsigned long window_errors = get_window_errors();
+    #endif
+
+    for (size_t i = 0; i < count; i++) {
+        if (post_event(&events[i]) == UIOHOOK_SUCCESS) {
+            posted++;
+        }
+    }
+
+    if (flags & POST_EVENTS_ASYNC) {
+        XFlush(helper_disp);
+    } else {
+        XSync(helper_disp, True);
+
+        #ifndef USE_XTEST
+        // Which events were lost is unknown, the caches are reset for the next call.
+        if (get_window_errors() != window_errors) {
+            logger(LOG_LEVEL_WARN, "%s [%u]: A target window was destroyed while posting!\n",
+                    __FUNCTION__, __LINE__);
+        }
+        #endif
+    }
     XUnlockDisplay(helper_disp);
+
+    logger(LOG_LEVEL_DEBUG, "%s [%u]: Posted %zu of %zu events.\n",
+            __FUNCTION__, __LINE__, posted, count);
+
+    return posted;
+}
+
+#ifdef USE_XTEST
+// Number of unused keycodes hook_post_text() binds to characters missing from the keymap.
+#define POST_TEXT_SPARE_KEYCODES 8
+
+/* Clients translate key events with the mapping current when they read them,
+ * not when they were sent, so a spare keycode is only rebound or restored once
+ * it has not been typed for this long.
+ */
+#define POST_TEXT_SETTLE_DELAY 100000000ULL
+
+// Spare keycode and the character bound to it, 0 while unbound.
+typedef struct _text_spare {
+    KeyCode keycode;
+    KeySym keysym;
+    uint32_t codepoint;
+    uint64_t used;
+} text_spare;
+
+// Core keyboard mapping and spare keycodes for one hook_post_text() call.
+typedef struct _text_keymap {
+    int min_keycode;
+    int keysyms_per_keycode;
+    int keycode_count;
+    KeySym *keysyms;
+    KeyCode shift;
+    text_spare spares[POST_TEXT_SPARE_KEYCODES];
+    size_t spare_count;
+} text_keymap;
+
+/* Serializes hook_post_text() calls, which give up the helper_disp lock while
+ * they wait for clients and must not pick the same spare keycodes.
+ */
+static pthread_mutex_t post_text_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static uint64_t text_time_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t) ts.tv_sec * 1000000000ULL + (uint64_t) ts.tv_nsec;
+}
+
+// Decode the next UTF-8 character, returns its length or 0 if the sequence is invalid.
+static size_t decode_utf8(const unsigned char *text, uint32_t *codepoint) {
+    size_t length;
+    uint32_t value;
+    if (text[0] < 0x80) {
+        *codepoint = text[0];
+        return 1;
+    } else if ((text[0] & 0xE0) == 0xC0) {
+        length = 2;
+        value = text[0] & 0x1F;
+    } else if ((text[0] & 0xF0) == 0xE0) {
+        length = 3;
+        value = text[0] & 0x0F;
+    } else if ((text[0] & 0xF8) == 0xF0) {
+        length = 4;
+        value = text[0] & 0x07;
+    } else {
+        return 0;
+    }
+
+    for (size_t i = 1; i < length; i++) {
+        if ((text[i] & 0xC0) != 0x80) {
+            return 0;
+        }
+        value = (value << 6) | (text[i] & 0x3F);
+    }
+
+    // Reject overlong forms, surrogates and values past the last plane.
+    static const uint32_t minimum[] = { 0, 0, 0x80, 0x800, 0x10000 };
+    if (value < minimum[length] || (value >= 0xD800 && value <= 0xDFFF) || value > 0x10FFFF) {
+        return 0;
+    }
+
+    *codepoint = value;
+    return length;
+}
+
+// Keysym typed for a character, control characters map to their function keys.
+static KeySym codepoint_to_keysym(uint32_t codepoint) {
+    switch (codepoint) {
+        case '\b':
+            return XK_BackSpace;
+        case '\t':
+            return XK_Tab;
+        case '\n':
+        case '\r':
+            return XK_Return;
+        case 0x1B:
+            return XK_Escape;
+        case 0x7F:
+            return XK_Delete;
+    }
+
+    if (codepoint > 0xFFFF) {
+        return codepoint | 0x01000000;
+    }
+
+    return unicode_to_keysym((uint16_t) codepoint);
+}
+
+/* Find a keycode producing the character in the first group, without or with
+ * Shift.  Any keysym translating to the character matches, not only the one
+ * returned by unicode_to_keysym().
+ */
+static KeyCode find_text_keycode(const text_keymap *map, uint32_t codepoint, KeySym keysym, bool *shifted) {
+    int levels = map->keysyms_per_keycode < 2 ? map->keysyms_per_keycode : 2;
+    for (int level = 0; level < levels; level++) {
+        for (int i = 0; i < map->keycode_count; i++) {
+            KeySym candidate = map->keysyms[i * map->keysyms_per_keycode + level];
+            if (candidate == NoSymbol) {
+                continue;
+            }
+
+            uint16_t unicode = 0x0000;
+            if (candidate == keysym || (codepoint <= 0xFFFF
+                    && keysym_to_unicode(candidate, &unicode, 1) == 1 && unicode == codepoint)) {
+                *shifted = level == 1;
+                return (KeyCode) (map->min_keycode + i);
+            }
+        }
+    }
+
+    return 0;
+}
+
+/* Let the server deliver the events typed so far, then give clients until
+ * POST_TEXT_SETTLE_DELAY after the last use to read them.  The helper_disp lock
+ * is released while sleeping so other threads can keep posting.
+ */
+static void wait_for_clients(uint64_t used) {
+    XSync(helper_disp, False);
+
+    uint64_t now = text_time_ns();
+    if (now - used < POST_TEXT_SETTLE_DELAY) {
+        uint64_t delay = POST_TEXT_SETTLE_DELAY - (now - used);
+        struct timespec ts = {
+            .tv_sec = (time_t) (delay / 1000000000ULL),
+            .tv_nsec = (long) (delay % 1000000000ULL)
+        };
+
+        XUnlockDisplay(helper_disp);
+        while (nanosleep(&ts, &ts) == -1 && errno == EINTR);
+        XLockDisplay(helper_disp);
+    }
+}
+
+static bool load_text_keymap(text_keymap *map) {
+    int min_keycode, max_keycode;
+    XDisplayKeycodes(helper_disp, &min_keycode, &max_keycode);
+
+    map->min_keycode = min_keycode;
+    map->keycode_count = max_keycode - min_keycode + 1;
+    map->keysyms = XGetKeyboardMapping(helper_disp, (KeyCode) min_keycode, map->keycode_count,
+            &map->keysyms_per_keycode);
+    if (map->keysyms == NULL) {
+        return false;
+    }
+
+    bool shifted;
+    map->shift = find_text_keycode(map, 0, XK_Shift_L, &shifted);
+    if (map->shift == 0) {
+        map->shift = find_text_keycode(map, 0, XK_Shift_R, &shifted);
+    }
+
+    // Keycodes without a single keysym are free to bind, search from the top.
+    map->spare_count = 0;
+    for (int i = map->keycode_count - 1; i >= 0 && map->spare_count < POST_TEXT_SPARE_KEYCODES; i--) {
+        bool unused = true;
+        for (int level = 0; level < map->keysyms_per_keycode && unused; level++) {
+            unused = map->keysyms[i * map->keysyms_per_keycode + level] == NoSymbol;
+        }
+
+        if (unused) {
+            map->spares[map->spare_count].keycode = (KeyCode) (map->min_keycode + i);
+            map->spares[map->spare_count].keysym = NoSymbol;
+            map->spares[map->spare_count].codepoint = 0;
+            map->spares[map->spare_count].used = 0;
+            map->spare_count++;
+        }
+    }
+
+    return true;
+}
+
+// Bind a spare keycode to the keysym, both levels so Shift does not matter.
+static KeyCode bind_spare_keycode(text_keymap *map, uint32_t codepoint, KeySym keysym) {
+    if (map->spare_count == 0) {
+        return 0;
+    }
+
+    // Prefer a keycode already holding the character, then an unbound one, then the least recently typed.
+    text_spare *spare = &map->spares[0];
+    for (size_t i = 0; i < map->spare_count; i++) {
+        if (map->spares[i].codepoint == codepoint) {
+            return map->spares[i].keycode;
+        } else if (spare->codepoint != 0
+                && (map->spares[i].codepoint == 0 || map->spares[i].used < spare->used)) {
+            spare = &map->spares[i];
+        }
+    }
+
+    if (spare->codepoint != 0) {
+        wait_for_clients(spare->used);
+    }
+
+    KeySym keysyms[2] = { keysym, keysym };
+    XChangeKeyboardMapping(helper_disp, spare->keycode, 2, keysyms, 1);
+    spare->keysym = keysym;
+    spare->codepoint = codepoint;
+
+    // Keep our copy in step so the old character is not found on this keycode.
+    KeySym *entry = &map->keysyms[(spare->keycode - map->min_keycode) * map->keysyms_per_keycode];
+    for (int level = 0; level < map->keysyms_per_keycode; level++) {
+        entry[level] = level < 2 ? keysym : NoSymbol;
+    }
+
+    return spare->keycode;
+}
+
+// Remember when a spare keycode was last typed.
+static void touch_spare_keycode(text_keymap *map, KeyCode keycode) {
+    for (size_t i = 0; i < map->spare_count; i++) {
+        if (map->spares[i].keycode == keycode) {
+            map->spares[i].used = text_time_ns();
+            break;
+        }
+    }
+}
+
+// Unbind every spare keycode once clients had time to read the events typed with them.
+static void restore_spare_keycodes(text_keymap *map) {
+    uint64_t used = 0;
+    for (size_t i = 0; i < map->spare_count; i++) {
+        if (map->spares[i].codepoint != 0 && map->spares[i].used > used) {
+            used = map->spares[i].used;
+        }
+    }
+
+    if (used == 0) {
+        return;
+    }
+
+    wait_for_clients(used);
+
+    KeySym keysyms[2] = { NoSymbol, NoSymbol };
+    for (size_t i = 0; i < map->spare_count; i++) {
+        if (map->spares[i].codepoint != 0) {
+            XChangeKeyboardMapping(helper_disp, map->spares[i].keycode, 2, keysyms, 1);
+            map->spares[i].keysym = NoSymbol;
+            map->spares[i].codepoint = 0;
+        }
+    }
+}
+#endif
+
+UIOHOOK_API size_t hook_post_text(const char *utf8) {
+    load_post_display();
+
+    if (helper_disp == NULL) {
+        logger(LOG_LEVEL_ERROR, "%s [%u]: XDisplay helper_disp is unavailable!\n",
+            __FUNCTION__, __LINE__);
+        return 0;
+    }
+
+    #ifdef USE_XTEST
+    size_t posted = 0;
+
+    pthread_mutex_lock(&post_text_mutex);
+    XLockDisplay(helper_disp);
+
+    text_keymap map;
+    if (!load_text_keymap(&map)) {
+        XUnlockDisplay(helper_disp);
+        pthread_mutex_unlock(&post_text_mutex);
+
+        logger(LOG_LEVEL_ERROR, "%s [%u]: XGetKeyboardMapping() failed!\n",
+            __FUNCTION__, __LINE__);
+        return 0;
+    }
+
+    const unsigned char *text = (const unsigned char *) utf8;
+    while (*text != '\0') {
+        uint32_t codepoint;
+        size_t length = decode_utf8(text, &codepoint);
+        if (length == 0) {
+            logger(LOG_LEVEL_WARN, "%s [%u]: Skipping invalid UTF-8 byte %#X.\n",
+                __FUNCTION__, __LINE__, *text);
+            text++;
+            continue;
+        }
+        text += length;
+
+        KeySym keysym = codepoint_to_keysym(codepoint);
+
+        bool shifted = false;
+        KeyCode keycode = find_text_keycode(&map, codepoint, keysym, &shifted);
+        if (keycode == 0 || (shifted && map.shift == 0)) {
+            shifted = false;
+            keycode = bind_spare_keycode(&map, codepoint, keysym);
+        }
+
+        if (keycode == 0) {
+            logger(LOG_LEVEL_WARN, "%s [%u]: No keycode available for U+%04X.\n",
+                __FUNCTION__, __LINE__, codepoint);
+            continue;
+        }
+
+        if (shifted) {
+            XTestFakeKeyEvent(helper_disp, map.shift, True, 0);
+        }
+        XTestFakeKeyEvent(helper_disp, keycode, True, 0);
+        XTestFakeKeyEvent(helper_disp, keycode, False, 0);
+        if (shifted) {
+            XTestFakeKeyEvent(helper_disp, map.shift, False, 0);
+        }
+        touch_spare_keycode(&map, keycode);
+
+        posted++;
+    }
+
+    // Nothing stays rebound once we return.
+    restore_spare_keycodes(&map);
+    XSync(helper_disp, True);
+
+    XUnlockDisplay(helper_disp);
+    pthread_mutex_unlock(&post_text_mutex);
+    XFree(map.keysyms);
+
+    logger(LOG_LEVEL_DEBUG, "%s [%u]: Posted %zu characters.\n",
+            __FUNCTION__, __LINE__, posted);
+
+    return posted;
+    #else
+    logger(LOG_LEVEL_ERROR, "%s [%u]: Posting text requires the XTest extension!\n",
+        __FUNCTION__, __LINE__);
+    return 0;
+    #endif
 }
@@ -0,0 +1,215 @@
+/* libUIOHook: Cross-platform keyboard and mouse hooking from userland.
+ * Copyright (C) 2006-2023 Alexander Barker.  All Rights Reserved.
+ * https://github.com/kwhat/libuiohook/
+ *
+ * libUIOHook is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libUIOHook is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <errno.h>
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <time.h>
+#include <uiohook.h>
+
+#include "input_helper.h"
+#include "logger.h"
+
+// Sleep until this long before a deadline, then spin the rest of the way.
+#define REPLAY_SPIN_NS          200000
+
+// Lateness histogram resolution and range, later events share the last bucket.
+#define REPLAY_BUCKET_NS        10000
+#define REPLAY_BUCKETS          1001
+
+#define NS_PER_MS               1000000
+
+// Posts the replayed events, see set_replay_sink().
+static replay_sink_t replay_sink = &hook_post_events;
+
+#ifdef USE_SYNTHETIC_HOOK
+void set_replay_sink(replay_sink_t sink) {
+    replay_sink = sink != NULL ? sink : &hook_post_events;
+}
+#endif
+
+static uint64_t now_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t) ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+// Wait for an absolute CLOCK_MONOTONIC deadline.
+static void wait_until(uint64_t deadline) {
+    uint64_t now = now_ns();
+    if (deadline > now + REPLAY_SPIN_NS) {
+        uint64_t wake = deadline - REPLAY_SPIN_NS;
+        struct timespec ts = { (time_t) (wake / 1000000000), (long) (wake % 1000000000) };
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR);
+
+        now = now_ns();
+    }
+
+    // The scheduler wakes us late by tens of microseconds, spinning hides that.
+    while (now < deadline) {
+        now = now_ns();
+    }
+}
+
+// Only these types can be posted, the rest are derived by the receiving hook.
+static bool is_postable(event_type type) {
+    switch (type) {
+        case EVENT_KEY_PRESSED:
+        case EVENT_KEY_RELEASED:
+        case EVENT_MOUSE_PRESSED:
+        case EVENT_MOUSE_RELEASED:
+        case EVENT_MOUSE_MOVED:
+        case EVENT_MOUSE_DRAGGED:
+        case EVENT_MOUSE_WHEEL:
+            return true;
+
+        default:
+            return false;
+    }
+}
+
+// Upper bound of the bucket holding the given fraction of the events.
+static uint64_t histogram_percentile(const uint64_t *buckets, uint64_t count, double fraction) {
+    uint64_t target = (uint64_t) (fraction * count + 0.5), seen = 0;
+    for (unsigned int i = 0; i < REPLAY_BUCKETS; i++) {
+        seen += buckets[i];
+        if (seen >= target && seen > 0) {
+            return (uint64_t) (i + 1) * REPLAY_BUCKET_NS;
+        }
+    }
+
+    return (uint64_t) REPLAY_BUCKETS * REPLAY_BUCKET_NS;
+}
+
+UIOHOOK_API int hook_replay(replay_source_t source, void *arg, double speed, replay_stats *stats) {
+    if (source == NULL || !(speed > 0)) {
+        logger(LOG_LEVEL_ERROR, "%s [%u]: Invalid replay source or speed!\n",
+                __FUNCTION__, __LINE__);
+
+        return UIOHOOK_FAILURE;
+    }
+
+    uint64_t *buckets = calloc(REPLAY_BUCKETS, sizeof(uint64_t));
+    if (buckets == NULL) {
+        logger(LOG_LEVEL_ERROR, "%s [%u]: Failed to allocate memory for replay statistics!\n",
+                __FUNCTION__, __LINE__);
+
+        return UIOHOOK_ERROR_OUT_OF_MEMORY;
+    }
+
+    replay_stats result = { 0, 0, 0, 0, 0, 0, 0, 0, 0 };
+    uint64_t total_late = 0;
+
+    uiohook_event event;
+    bool started = false;
+    uint64_t start = 0, first_time = 0, deadline = 0;
+    while (source(&event, arg)) {
+        if (!started) {
+            start = now_ns();
+            first_time = event.time;
+            deadline = start;
+            started = true;
+        }
+
+        // Typed, clicked and hook events are never posted, nor waited for.
+        if (!is_postable(event.type)) {
+            result.skipped++;
+            continue;
+        }
+
+        /* Deadlines are computed from the start of the replay rather than the
+         * previous event, so sleep overshoot and posting time never add up.
+         * Timestamps that go backwards keep the previous deadline, so they are
+         * posted straight away and measured against it.
+         */
+        if (event.time > first_time) {
+            uint64_t offset = (uint64_t) ((event.time - first_time) * (double) NS_PER_MS / speed);
+            if (start + offset > deadline) {
+                deadline = start + offset;
+            }
+        }
+
+        wait_until(deadline);
+        if (replay_sink(&event, 1, POST_EVENTS_ASYNC) == 0) {
+            result.failed++;
+            continue;
+        }
+
+        // An event is late until hook_post_events() has handed it to the server.
+        uint64_t late = now_ns() - deadline;
+        buckets[late / REPLAY_BUCKET_NS < REPLAY_BUCKETS ? late / REPLAY_BUCKET_NS : REPLAY_BUCKETS - 1]++;
+        total_late += late;
+
+        if (late > result.late_max_ns) {
+            result.late_max_ns = late;
+        }
+        if (late > NS_PER_MS) {
+            result.late_over_1ms++;
+        }
+        result.posted++;
+    }
+
+    if (result.posted > 0) {
+        result.late_mean_ns = total_late / result.posted;
+        result.late_p50_ns = histogram_percentile(buckets, result.posted, 0.50);
+        result.late_p99_ns = histogram_percentile(buckets, result.posted, 0.99);
+    }
+
+    if (started) {
+        result.duration_ns = now_ns() - start;
+    }
+    free(buckets);
+
+    logger(LOG_LEVEL_DEBUG, "%s [%u]: Replayed %" PRIu64 " events, skipped %" PRIu64 ", failed %" PRIu64
+            ", mean lateness %" PRIu64 " ns, max %" PRIu64 " ns.\n",
+            __FUNCTION__, __LINE__, result.posted, result.skipped, result.failed,
+            result.late_mean_ns, result.late_max_ns);
+
+    if (stats != NULL) {
+        *stats = result;
+    }
+
+    return UIOHOOK_SUCCESS;
+}
+
+// Source for hook_replay_events().
+typedef struct _array_source {
+    const uiohook_event *events;
+    size_t count;
+    size_t next;
+} array_source;
+
+static bool array_source_proc(uiohook_event *event, void *arg) {
+    array_source *array = (array_source *) arg;
+    if (array->next >= array->count) {
+        return false;
+    }
+
+    *event = array->events[array->next++];
+
+    return true;
+}
+
+UIOHOOK_API int hook_replay_events(const uiohook_event *events, size_t count, double speed, replay_stats *stats) {
+    array_source array = { events, count, 0 };
+
+    return hook_replay(&array_source_proc, &array, speed, stats);
+}
@@ -0,0 +1,64 @@
+/* libUIOHook: Cross-platform keyboard and mouse hooking from userland.
+ * Copyright (C) 2006-2023 Alexander Barker.  All Rights Reserved.
+ * https://github.com/kwhat/libuiohook/
+ *
+ * libUIOHook is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libUIOHook is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "snapshot.h"
+
+/* Readers count themselves in the slot selected by the epoch before loading
+ * the data.  Anyone still using the old data therefore registered before it
+ * was replaced, in one of the two slots.  Flipping the epoch sends new readers
+ * to the other slot, so each slot drains in turn.
+ */
+const void * snapshot_acquire(snapshot *snap, unsigned int *slot) {
+    *slot = __atomic_load_n(&snap->epoch, __ATOMIC_SEQ_CST) & 1;
+    __atomic_add_fetch(&snap->readers[*slot], 1, __ATOMIC_SEQ_CST);
+
+    return __atomic_load_n(&snap->current, __ATOMIC_SEQ_CST);
+}
+
+void snapshot_release(snapshot *snap, unsigned int slot) {
+    __atomic_sub_fetch(&snap->readers[slot], 1, __ATOMIC_RELEASE);
+}
+
+// Move new readers to the other slot and wait for the old slot to empty.
+static void wait_for_readers(snapshot *snap) {
+    unsigned int slot = __atomic_fetch_add(&snap->epoch, 1, __ATOMIC_SEQ_CST) & 1;
+
+    // Readers only hold a snapshot for a few reads, sleep rather than spin.
+    while (__atomic_load_n(&snap->readers[slot], __ATOMIC_ACQUIRE) != 0) {
+        struct timespec delay = { 0, 10000 };
+        nanosleep(&delay, NULL);
+    }
+}
+
+void snapshot_publish(snapshot *snap, void *data) {
+    pthread_mutex_lock(&snap->mutex);
+    void *previous = __atomic_exchange_n(&snap->current, data, __ATOMIC_SEQ_CST);
+
+    if (previous != NULL) {
+        // Both slots, a reader may have registered just before the first flip.
+        wait_for_readers(snap);
+        wait_for_readers(snap);
+
+        free(previous);
+    }
+    pthread_mutex_unlock(&snap->mutex);
+}
@@ -0,0 +1,55 @@
+/* libUIOHook: Cross-platform keyboard and mouse hooking from userland.
+ * Copyright (C) 2006-2023 Alexander Barker.  All Rights Reserved.
+ * https://github.com/kwhat/libuiohook/
+ *
+ * libUIOHook is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libUIOHook is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _included_snapshot
+#define _included_snapshot
+
+#include <pthread.h>
+
+/* Immutable data shared with readers that never block.  Readers bracket every
+ * use with snapshot_acquire() and snapshot_release().  A publish swaps in the
+ * new data and then waits for every reader that could still see the old data
+ * before freeing it, so a reader is never left with freed memory no matter how
+ * often the data is replaced.
+ */
+typedef struct _snapshot {
+    void *current;
+    unsigned int epoch;
+    unsigned long readers[2];
+    pthread_mutex_t mutex;
+} snapshot;
+
+#define SNAPSHOT_INITIALIZER { NULL, 0, { 0, 0 }, PTHREAD_MUTEX_INITIALIZER }
+
+/* Returns the current data, or NULL if nothing has been published, and stores
+ * the slot to hand back to snapshot_release().  The data stays valid until
+ * then.  Readers must not publish while holding a snapshot.
+ */
+extern const void * snapshot_acquire(snapshot *snap, unsigned int *slot);
+
+/* End the use of the data returned by snapshot_acquire().
+ */
+extern void snapshot_release(snapshot *snap, unsigned int slot);
+
+/* Replace the current data with data, which may be NULL, and free() the
+ * previous data once no reader can be using it.  Blocks until then, so it must
+ * not be called from a thread holding a snapshot.
+ */
+extern void snapshot_publish(snapshot *snap, void *data);
+
+#endif
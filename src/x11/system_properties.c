@@ -16,11 +16,18 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <limits.h>
+#include <poll.h>
+#include <pthread.h>
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <time.h>
 #include <uiohook.h>
+#include <X11/Xatom.h>
 #include <X11/Xlib.h>
+#include <X11/Xresource.h>
 #include <X11/XKBlib.h>
 
 #ifdef USE_XF86MISC
@@ -31,7 +38,6 @@
 #if defined(USE_XINERAMA) && !defined(USE_XRANDR)
 #include <X11/extensions/Xinerama.h>
 #elif defined(USE_XRANDR)
-#include <pthread.h>
 #include <X11/extensions/Xrandr.h>
 #endif
 
@@ -44,27 +50,390 @@ static Display *xt_disp;
 
 #include "input_helper.h"
 #include "logger.h"
+#include "snapshot.h"
 
-#ifdef USE_XRANDR
-static pthread_mutex_t xrandr_mutex = PTHREAD_MUTEX_INITIALIZER;
-static XRRScreenResources *xrandr_resources = NULL;
+// Current monitor layout snapshot.
+static snapshot layout_snapshot = SNAPSHOT_INITIALIZER;
 
-static void settings_cleanup_proc(void *arg) {
-    if (pthread_mutex_trylock(&xrandr_mutex) == 0) {
-        if (xrandr_resources != NULL) {
-            XRRFreeScreenResources(xrandr_resources);
-            xrandr_resources = NULL;
+// Resources created on first use by load_helper_display(), load_multi_click_time() and load_settings_thread().
+static pthread_once_t helper_display_once = PTHREAD_ONCE_INIT;
+static pthread_once_t multi_click_time_once = PTHREAD_ONCE_INIT;
+static pthread_once_t settings_thread_once = PTHREAD_ONCE_INIT;
+
+static screen_layout * create_screen_layout(Display *disp) {
+    screen_layout *layout = NULL;
+
+    #if defined(USE_XINERAMA) && !defined(USE_XRANDR)
+    int xine_count = 0;
+    XineramaScreenInfo *xine_info = NULL;
+    if (XineramaIsActive(disp)) {
+        xine_info = XineramaQueryScreens(disp, &xine_count);
+    }
+
+    if (xine_count > UINT8_MAX) {
+        logger(LOG_LEVEL_WARN, "%s [%u]: Screen count overflow detected!\n",
+                __FUNCTION__, __LINE__);
+
+        xine_count = UINT8_MAX;
+    }
+
+    layout = malloc(sizeof(screen_layout) + sizeof(screen_data) * xine_count);
+    if (layout != NULL) {
+        layout->count = (uint8_t) xine_count;
+
+        for (int i = 0; i < xine_count; i++) {
+            layout->screens[i] = (screen_data) {
+                .number = xine_info[i].screen_number,
+                .x = xine_info[i].x_org,
+                .y = xine_info[i].y_org,
+                .width = xine_info[i].width,
+                .height = xine_info[i].height
+            };
+        }
+    }
+
+    if (xine_info != NULL) {
+        XFree(xine_info);
+    }
+    #elif defined(USE_XRANDR)
+    XRRScreenResources *xrandr_resources = XRRGetScreenResourcesCurrent(disp, XDefaultRootWindow(disp));
+    if (xrandr_resources == NULL) {
+        logger(LOG_LEVEL_WARN, "%s [%u]: XRandR could not get screen resources!\n",
+                __FUNCTION__, __LINE__);
+
+        return NULL;
+    }
+
+    int xrandr_count = xrandr_resources->ncrtc;
+    if (xrandr_count > UINT8_MAX) {
+        logger(LOG_LEVEL_WARN, "%s [%u]: Screen count overflow detected!\n",
+                __FUNCTION__, __LINE__);
+
+        xrandr_count = UINT8_MAX;
+    }
+
+    layout = malloc(sizeof(screen_layout) + sizeof(screen_data) * xrandr_count);
+    if (layout != NULL) {
+        layout->count = (uint8_t) xrandr_count;
+
+        for (int i = 0; i < xrandr_count; i++) {
+            XRRCrtcInfo *crtc_info = XRRGetCrtcInfo(disp, xrandr_resources, xrandr_resources->crtcs[i]);
+
+            if (crtc_info != NULL) {
+                layout->screens[i] = (screen_data) {
+                    .number = i + 1,
+                    .x = crtc_info->x,
+                    .y = crtc_info->y,
+                    .width = crtc_info->width,
+                    .height = crtc_info->height
+                };
+
+                XRRFreeCrtcInfo(crtc_info);
+            } else {
+                logger(LOG_LEVEL_WARN, "%s [%u]: XRandr failed to return crtc information! (%#X)\n",
+                        __FUNCTION__, __LINE__, xrandr_resources->crtcs[i]);
+
+                layout->screens[i] = (screen_data) { .number = i + 1 };
+            }
+        }
+    }
+
+    XRRFreeScreenResources(xrandr_resources);
+    #else
+    Screen* default_screen = DefaultScreenOfDisplay(disp);
+
+    layout = malloc(sizeof(screen_layout) + sizeof(screen_data));
+    if (layout != NULL) {
+        layout->count = 0;
+
+        if (default_screen->width > 0 && default_screen->height > 0) {
+            layout->count = 1;
+            layout->screens[0] = (screen_data) {
+                .number = 1,
+                .x = 0,
+                .y = 0,
+                .width = default_screen->width,
+                .height = default_screen->height
+            };
+        }
+    }
+    #endif
+
+    if (layout == NULL) {
+        logger(LOG_LEVEL_ERROR, "%s [%u]: Failed to allocate memory for screen layout!\n",
+                __FUNCTION__, __LINE__);
+    }
+
+    return layout;
+}
+
+static void publish_screen_layout(screen_layout *layout) {
+    if (layout != NULL) {
+        // Waits for readers of the previous snapshot before it is freed.
+        snapshot_publish(&layout_snapshot, layout);
+    }
+}
+
+static void release_screen_layout() {
+    snapshot_publish(&layout_snapshot, NULL);
+}
+
+const screen_layout * get_screen_layout(unsigned int *slot) {
+    return snapshot_acquire(&layout_snapshot, slot);
+}
+
+void put_screen_layout(unsigned int slot) {
+    snapshot_release(&layout_snapshot, slot);
+}
+
+#ifndef USE_XTEST
+// Window with the input focus and the number of times it has been updated.
+static Window focus_window = None;
+static unsigned long focus_generation = 0;
+
+// Window the settings thread selected focus and structure events on.
+static Window followed_window = None;
+
+// Display of the settings thread, set while it is running.
+static Display *settings_display = NULL;
+
+// Number of BadWindow errors caused by the library displays.
+static unsigned long window_errors = 0;
+
+// Error handler that was installed before window_error_proc().
+static XErrorHandler previous_error_handler = NULL;
+
+static void update_focus_window(Display *disp) {
+    Window focus = None;
+    int revert;
+    XGetInputFocus(disp, &focus, &revert);
+
+    __atomic_store_n(&focus_window, focus, __ATOMIC_RELEASE);
+    __atomic_add_fetch(&focus_generation, 1, __ATOMIC_RELEASE);
+}
+
+/* Update the focus window and select events on it, so that focus moving away
+ * from it is seen even without a window manager announcing it and when the
+ * client moves the focus itself.
+ */
+static void follow_focus_window(Display *disp, Window root) {
+    update_focus_window(disp);
+
+    Window focus = get_focus_window();
+    if (focus != followed_window) {
+        if (followed_window != None) {
+            XSelectInput(disp, followed_window, NoEventMask);
+        }
+
+        if (focus != None && focus != PointerRoot && focus != root) {
+            XSelectInput(disp, focus, FocusChangeMask | StructureNotifyMask);
+            followed_window = focus;
+        } else {
+            followed_window = None;
+        }
+    }
+}
+
+/* Cached windows can be destroyed by their clients at any time.  BadWindow
+ * errors from the library displays only invalidate the caches rather than
+ * reaching the default handler, which exits the process.
+ */
+static int window_error_proc(Display *disp, XErrorEvent *error) {
+    if (error->error_code == BadWindow
+            && (disp == helper_disp || disp == __atomic_load_n(&settings_display, __ATOMIC_ACQUIRE))) {
+        logger(LOG_LEVEL_DEBUG, "%s [%u]: Window %#lX no longer exists.\n",
+                __FUNCTION__, __LINE__, error->resourceid);
+
+        Window window = error->resourceid;
+        __atomic_compare_exchange_n(&focus_window, &window, None, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+        __atomic_add_fetch(&focus_generation, 1, __ATOMIC_RELEASE);
+        if (disp == helper_disp) {
+            __atomic_add_fetch(&window_errors, 1, __ATOMIC_RELEASE);
+        }
+
+        return 0;
+    }
+
+    return previous_error_handler != NULL ? previous_error_handler(disp, error) : 0;
+}
+
+Window get_focus_window() {
+    return __atomic_load_n(&focus_window, __ATOMIC_ACQUIRE);
+}
+
+unsigned long get_focus_generation() {
+    return __atomic_load_n(&focus_generation, __ATOMIC_ACQUIRE);
+}
+
+unsigned long get_window_errors() {
+    return __atomic_load_n(&window_errors, __ATOMIC_ACQUIRE);
+}
+#endif
+
+// Multi-click time cached from the X resource database.
+static long int multi_click_time = 200;
+
+#ifdef USE_SYNTHETIC_HOOK
+// Number of resource database reads, only kept for the tests and benchmarks.
+static unsigned long multi_click_time_lookups = 0;
+#endif
+
+static long int lookup_multi_click_time() {
+    long int value = 200;
+    int click_time;
+    bool successful = false;
+
+    #ifdef USE_SYNTHETIC_HOOK
+    __atomic_add_fetch(&multi_click_time_lookups, 1, __ATOMIC_RELAXED);
+    #endif
+
+    #ifdef USE_XT
+    // Check and make sure we could connect to the x server.
+    if (xt_disp != NULL) {
+        // Try and use the Xt extention to get the current multi-click.
+        if (!successful) {
+            // Fall back to the X Toolkit extension if available and other efforts failed.
+            click_time = XtGetMultiClickTime(xt_disp);
+            if (click_time >= 0) {
+                logger(LOG_LEVEL_DEBUG, "%s [%u]: XtGetMultiClickTime: %i.\n",
+                        __FUNCTION__, __LINE__, click_time);
+
+                successful = true;
+            }
+        }
+    } else {
+        logger(LOG_LEVEL_ERROR, "%s [%u]: %s\n",
+                __FUNCTION__, __LINE__, "XOpenDisplay failure!");
+    }
+    #endif
+
+    // Check and make sure we could connect to the x server.
+    if (helper_disp != NULL) {
+        // Try and acquire the multi-click time from the user defined X defaults.
+        if (!successful) {
+            char *xprop = XGetDefault(helper_disp, "*", "multiClickTime");
+            if (xprop != NULL && sscanf(xprop, "%4i", &click_time) != EOF) {
+                logger(LOG_LEVEL_DEBUG, "%s [%u]: X default 'multiClickTime' property: %i.\n",
+                        __FUNCTION__, __LINE__, click_time);
+
+                successful = true;
+            }
+        }
+
+        if (!successful) {
+            char *xprop = XGetDefault(helper_disp, "OpenWindows", "MultiClickTimeout");
+            if (xprop != NULL && sscanf(xprop, "%4i", &click_time) != EOF) {
+                logger(LOG_LEVEL_DEBUG, "%s [%u]: X default 'MultiClickTimeout' property: %i.\n",
+                        __FUNCTION__, __LINE__, click_time);
+
+                successful = true;
+            }
         }
+    } else {
+        logger(LOG_LEVEL_WARN, "%s [%u]: XDisplay helper_disp is unavailable!\n",
+            __FUNCTION__, __LINE__);
+    }
+
+    if (successful) {
+        value = (long int) click_time;
+    }
+
+    return value;
+}
+
+/* The resource database returned by XGetDefault() and Xt is parsed once when
+ * the display is opened, so changes made with xrdb are read directly from the
+ * RESOURCE_MANAGER property instead.
+ */
+static void update_multi_click_time(Display *disp, Atom resource_manager) {
+    long int value = 200;
+    int click_time;
+
+    #ifdef USE_SYNTHETIC_HOOK
+    __atomic_add_fetch(&multi_click_time_lookups, 1, __ATOMIC_RELAXED);
+    #endif
 
-        if (arg != NULL) {
-            XCloseDisplay((Display *) arg);
-            arg = NULL;
+    Atom type;
+    int format;
+    unsigned long nitems, remaining;
+    unsigned char *xdefaults = NULL;
+    if (XGetWindowProperty(disp, XDefaultRootWindow(disp), resource_manager, 0, LONG_MAX / 4, False,
+            XA_STRING, &type, &format, &nitems, &remaining, &xdefaults) == Success && xdefaults != NULL) {
+        XrmDatabase db = XrmGetStringDatabase((char *) xdefaults);
+        if (db != NULL) {
+            char *xrm_type;
+            XrmValue xrm_value;
+
+            // Same resources queried by Xt and XGetDefault() above.
+            if ((XrmGetResource(db, "UIOHook.multiClickTime", "libuiohook.MultiClickTime", &xrm_type, &xrm_value)
+                    || XrmGetResource(db, "OpenWindows.MultiClickTimeout", "OpenWindows.MultiClickTimeout", &xrm_type, &xrm_value))
+                    && xrm_value.addr != NULL && sscanf(xrm_value.addr, "%4i", &click_time) == 1) {
+                logger(LOG_LEVEL_DEBUG, "%s [%u]: X resource multi-click time: %i.\n",
+                        __FUNCTION__, __LINE__, click_time);
+
+                value = (long int) click_time;
+            }
+
+            XrmDestroyDatabase(db);
         }
 
-        pthread_mutex_unlock(&xrandr_mutex);
+        XFree(xdefaults);
+    }
+
+    __atomic_store_n(&multi_click_time, value, __ATOMIC_RELAXED);
+}
+
+// Read the initial multi-click time.
+static void multi_click_time_init() {
+    load_helper_display();
+
+    #ifdef USE_XT
+    XtToolkitInitialize();
+    xt_context = XtCreateApplicationContext();
+
+    int argc = 0;
+    char ** argv = { NULL };
+    xt_disp = XtOpenDisplay(xt_context, NULL, "UIOHook", "libuiohook", NULL, 0, &argc, argv);
+    #endif
+
+    __atomic_store_n(&multi_click_time, lookup_multi_click_time(), __ATOMIC_RELAXED);
+}
+
+static void load_multi_click_time() {
+    pthread_once(&multi_click_time_once, multi_click_time_init);
+}
+
+#ifdef USE_SYNTHETIC_HOOK
+unsigned long get_multi_click_time_lookups() {
+    return __atomic_load_n(&multi_click_time_lookups, __ATOMIC_RELAXED);
+}
+#endif
+
+static void settings_cleanup_proc(void *arg) {
+    if (arg != NULL) {
+        #ifndef USE_XTEST
+        __atomic_store_n(&settings_display, NULL, __ATOMIC_RELEASE);
+        #endif
+
+        XCloseDisplay((Display *) arg);
+        arg = NULL;
     }
 }
 
+#ifndef USE_XKB_COMMON
+/* Changing the layout sends a burst of MappingNotify events, reload the key
+ * translations once none has arrived for this many milliseconds.
+ */
+#define KEYMAP_SETTLE_TIME 50
+
+static long long settle_time_ms() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (long long) ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+#endif
+
 static void *settings_thread_proc(void *arg) {
     Display *settings_disp = XOpenDisplay(XDisplayName(NULL));;
     if (settings_disp != NULL) {
@@ -73,38 +442,139 @@ static void *settings_thread_proc(void *arg) {
 
         pthread_cleanup_push(settings_cleanup_proc, settings_disp);
 
+        Window root = XDefaultRootWindow(settings_disp);
+
+        // Changes to the resource database are announced on the root window.
+        Atom resource_manager = XInternAtom(settings_disp, "RESOURCE_MANAGER", False);
+        long event_mask = PropertyChangeMask;
+
+        #ifndef USE_XTEST
+        /* Focus changes are announced through _NET_ACTIVE_WINDOW by EWMH window
+         * managers and through FocusIn and FocusOut on the root and on the focus
+         * window otherwise.  Top level windows being mapped, moved or destroyed
+         * can change the window under the pointer or take the focus with them.
+         */
+        Atom net_active_window = XInternAtom(settings_disp, "_NET_ACTIVE_WINDOW", False);
+        event_mask |= FocusChangeMask | SubstructureNotifyMask;
+
+        __atomic_store_n(&settings_display, settings_disp, __ATOMIC_RELEASE);
+        #endif
+
+        #ifdef USE_XRANDR
         int event_base = 0;
         int error_base = 0;
         if (XRRQueryExtension(settings_disp, &event_base, &error_base)) {
-            Window root = XDefaultRootWindow(settings_disp);
-            unsigned long event_mask = RRScreenChangeNotifyMask;
-            XRRSelectInput(settings_disp, root, event_mask);
+            XRRSelectInput(settings_disp, root, RRScreenChangeNotifyMask);
+        } else {
+            logger(LOG_LEVEL_WARN, "%s [%u]: XRandR is not currently available!\n",
+                    __FUNCTION__, __LINE__);
+        }
+        #elif defined(USE_XINERAMA)
+        // Xinerama has no change notification, but any layout change that
+        // alters the size of the root window will reconfigure it.
+        event_mask |= StructureNotifyMask;
+        #endif
 
-            XEvent ev;
+        XSelectInput(settings_disp, root, event_mask);
 
-            while(settings_disp != NULL) {
-                XNextEvent(settings_disp, &ev);
+        #ifndef USE_XKB_COMMON
+        // A new keyboard can replace the keymap, core MappingNotify covers the rest.
+        int xkb_event_base = -1;
+        int xkb_opcode, xkb_error_base, xkb_major = XkbMajorVersion, xkb_minor = XkbMinorVersion;
+        if (XkbQueryExtension(settings_disp, &xkb_opcode, &xkb_event_base, &xkb_error_base, &xkb_major, &xkb_minor)) {
+            XkbSelectEvents(settings_disp, XkbUseCoreKbd, XkbNewKeyboardNotifyMask, XkbNewKeyboardNotifyMask);
+        } else {
+            xkb_event_base = -1;
+        }
+        #endif
 
-                if (ev.type == event_base + RRScreenChangeNotifyMask) {
-                    logger(LOG_LEVEL_DEBUG, "%s [%u]: Received XRRScreenChangeNotifyEvent.\n",
-                            __FUNCTION__, __LINE__);
+        #ifndef USE_XTEST
+        // The focus may have changed since the library was loaded.
+        follow_focus_window(settings_disp, root);
+        #endif
+
+        XEvent ev;
 
-                    pthread_mutex_lock(&xrandr_mutex);
-                    if (xrandr_resources != NULL) {
-                        XRRFreeScreenResources(xrandr_resources);
-                    }
-
-                    xrandr_resources = XRRGetScreenResources(settings_disp, root);
-                    if (xrandr_resources == NULL) {
-                        logger(LOG_LEVEL_WARN, "%s [%u]: XRandR could not get screen resources!\n",
-                                __FUNCTION__, __LINE__);
-                    }
-                    pthread_mutex_unlock(&xrandr_mutex);
-                } else {
-                    logger(LOG_LEVEL_WARN, "%s [%u]: XRandR is not currently available!\n",
+        #ifndef USE_XKB_COMMON
+        // Time of the last keyboard mapping change not yet loaded, or -1.
+        long long keymap_changed = -1;
+        #endif
+
+        while(settings_disp != NULL) {
+            #ifndef USE_XKB_COMMON
+            if (keymap_changed >= 0 && XPending(settings_disp) == 0) {
+                long long remaining = keymap_changed + KEYMAP_SETTLE_TIME - settle_time_ms();
+                struct pollfd fd = { .fd = ConnectionNumber(settings_disp), .events = POLLIN };
+                if (remaining <= 0 || poll(&fd, 1, (int) remaining) == 0) {
+                    logger(LOG_LEVEL_DEBUG, "%s [%u]: Keyboard mapping settled.\n",
                             __FUNCTION__, __LINE__);
+
+                    reload_key_translations(settings_disp);
+                    keymap_changed = -1;
+                    continue;
                 }
             }
+            #endif
+
+            XNextEvent(settings_disp, &ev);
+
+            if (ev.type == PropertyNotify && ev.xproperty.atom == resource_manager) {
+                logger(LOG_LEVEL_DEBUG, "%s [%u]: Received RESOURCE_MANAGER PropertyNotify.\n",
+                        __FUNCTION__, __LINE__);
+
+                update_multi_click_time(settings_disp, resource_manager);
+            }
+            #ifndef USE_XTEST
+            else if ((ev.type == PropertyNotify && ev.xproperty.atom == net_active_window)
+                    || ev.type == FocusIn || ev.type == FocusOut) {
+                logger(LOG_LEVEL_DEBUG, "%s [%u]: Received focus change.\n",
+                        __FUNCTION__, __LINE__);
+
+                follow_focus_window(settings_disp, root);
+            }
+            else if (ev.type == MapNotify || ev.type == UnmapNotify || ev.type == DestroyNotify) {
+                logger(LOG_LEVEL_DEBUG, "%s [%u]: Received window %#lX map state change.\n",
+                        __FUNCTION__, __LINE__, ev.xany.window);
+
+                follow_focus_window(settings_disp, root);
+            }
+            else if (ev.type == ConfigureNotify && ev.xconfigure.window != root) {
+                // Only the window under the pointer can change, the focus stays.
+                __atomic_add_fetch(&focus_generation, 1, __ATOMIC_RELEASE);
+            }
+            #endif
+            else if (ev.type == MappingNotify && ev.xmapping.request == MappingPointer) {
+                logger(LOG_LEVEL_DEBUG, "%s [%u]: Received pointer MappingNotify.\n",
+                        __FUNCTION__, __LINE__);
+
+                update_button_map(settings_disp);
+            }
+            #ifndef USE_XKB_COMMON
+            else if ((ev.type == MappingNotify
+                        && (ev.xmapping.request == MappingKeyboard || ev.xmapping.request == MappingModifier))
+                    || (ev.type == xkb_event_base && ((XkbEvent *) &ev)->any.xkb_type == XkbNewKeyboardNotify)) {
+                logger(LOG_LEVEL_DEBUG, "%s [%u]: Received keyboard mapping change.\n",
+                        __FUNCTION__, __LINE__);
+
+                keymap_changed = settle_time_ms();
+            }
+            #endif
+            #ifdef USE_XRANDR
+            else if (ev.type == event_base + RRScreenChangeNotify) {
+                logger(LOG_LEVEL_DEBUG, "%s [%u]: Received XRRScreenChangeNotifyEvent.\n",
+                        __FUNCTION__, __LINE__);
+
+                XRRUpdateConfiguration(&ev);
+                publish_screen_layout(create_screen_layout(settings_disp));
+            }
+            #elif defined(USE_XINERAMA)
+            else if (ev.type == ConfigureNotify && ev.xconfigure.window == root) {
+                logger(LOG_LEVEL_DEBUG, "%s [%u]: Received root window ConfigureNotify.\n",
+                        __FUNCTION__, __LINE__);
+
+                publish_screen_layout(create_screen_layout(settings_disp));
+            }
+            #endif
         }
 
         // Execute the thread cleanup handler.
@@ -117,105 +587,36 @@ static void *settings_thread_proc(void *arg) {
 
     return NULL;
 }
-#endif
 
 UIOHOOK_API screen_data* hook_create_screen_info(unsigned char *count) {
     *count = 0;
     screen_data *screens = NULL;
 
-    // Check and make sure we could connect to the x server.
-    if (helper_disp != NULL) {
-        #if defined(USE_XINERAMA) && !defined(USE_XRANDR)
-        if (XineramaIsActive(helper_disp)) {
-            int xine_count = 0;
-            XineramaScreenInfo *xine_info = XineramaQueryScreens(helper_disp, &xine_count);
-
-            if (xine_info != NULL) {
-                if (xine_count > UINT8_MAX) {
-                    *count = UINT8_MAX;
-
-                    logger(LOG_LEVEL_WARN, "%s [%u]: Screen count overflow detected!\n",
-                            __FUNCTION__, __LINE__);
-                } else {
-                    *count = (uint8_t) xine_count;
-                }
-
-                screens = malloc(sizeof(screen_data) * xine_count);
-
-                if (screens != NULL) {
-                    for (int i = 0; i < xine_count; i++) {
-                        screens[i] = (screen_data) {
-                            .number = xine_info[i].screen_number,
-                            .x = xine_info[i].x_org,
-                            .y = xine_info[i].y_org,
-                            .width = xine_info[i].width,
-                            .height = xine_info[i].height
-                        };
-                    }
-                }
-
-                XFree(xine_info);
-            }
-        }
-        #elif defined(USE_XRANDR)
-        pthread_mutex_lock(&xrandr_mutex);
-        if (xrandr_resources != NULL) {
-            int xrandr_count = xrandr_resources->ncrtc;
-            if (xrandr_count > UINT8_MAX) {
-                *count = UINT8_MAX;
-
-                logger(LOG_LEVEL_WARN, "%s [%u]: Screen count overflow detected!\n",
-                        __FUNCTION__, __LINE__);
-            } else {
-                *count = (uint8_t) xrandr_count;
-            }
-
-            screens = malloc(sizeof(screen_data) * xrandr_count);
-
-            if (screens != NULL) {
-                for (int i = 0; i < xrandr_count; i++) {
-                    XRRCrtcInfo *crtc_info = XRRGetCrtcInfo(helper_disp, xrandr_resources, xrandr_resources->crtcs[i]);
-
-                    if (crtc_info != NULL) {
-                        screens[i] = (screen_data) {
-                            .number = i + 1,
-                            .x = crtc_info->x,
-                            .y = crtc_info->y,
-                            .width = crtc_info->width,
-                            .height = crtc_info->height
-                        };
-
-                        XRRFreeCrtcInfo(crtc_info);
-                    } else {
-                        logger(LOG_LEVEL_WARN, "%s [%u]: XRandr failed to return crtc information! (%#X)\n",
-                                __FUNCTION__, __LINE__, xrandr_resources->crtcs[i]);
-                    }
-                }
-            }
-        }
-        pthread_mutex_unlock(&xrandr_mutex);
-        #else
-        Screen* default_screen = DefaultScreenOfDisplay(helper_disp);
+    #if defined(USE_XRANDR) || defined(USE_XINERAMA)
+    // The settings thread replaces the snapshot when the layout changes.
+    load_settings_thread();
+    #else
+    // Nothing announces layout changes, the snapshot taken with the display stays.
+    load_helper_display();
+    #endif
 
-        if (default_screen->width > 0 && default_screen->height > 0) {
-            screens = malloc(sizeof(screen_data));
+    // Copy the current layout snapshot; no server requests are made here.
+    unsigned int slot;
+    const screen_layout *layout = get_screen_layout(&slot);
+    if (layout != NULL) {
+        if (layout->count > 0) {
+            screens = malloc(sizeof(screen_data) * layout->count);
 
             if (screens != NULL) {
-                *count = 1;
-                screens[0] = (screen_data) {
-                    .number = 1,
-                    .x = 0,
-                    .y = 0,
-                    .width = default_screen->width,
-                    .height = default_screen->height
-                };
+                memcpy(screens, layout->screens, sizeof(screen_data) * layout->count);
+                *count = layout->count;
             }
         }
-        #endif
     } else {
         logger(LOG_LEVEL_WARN, "%s [%u]: XDisplay helper_disp is unavailable!\n",
             __FUNCTION__, __LINE__);
     }
+    put_screen_layout(slot);
 
     return screens;
 }
@@ -225,6 +626,8 @@ UIOHOOK_API long int hook_get_auto_repeat_rate() {
     long int value = -1;
     unsigned int delay = 0, rate = 0;
 
+    load_helper_display();
+
     // Check and make sure we could connect to the x server.
     if (helper_disp != NULL) {
         // Attempt to acquire the keyboard auto repeat rate using the XKB extension.
@@ -268,6 +671,8 @@ UIOHOOK_API long int hook_get_auto_repeat_delay() {
     long int value = -1;
     unsigned int delay = 0, rate = 0;
 
+    load_helper_display();
+
     // Check and make sure we could connect to the x server.
     if (helper_disp != NULL) {
         // Attempt to acquire the keyboard auto repeat rate using the XKB extension.
@@ -310,6 +715,8 @@ UIOHOOK_API long int hook_get_pointer_acceleration_multiplier() {
     long int value = -1;
     int accel_numerator, accel_denominator, threshold;
 
+    load_helper_display();
+
     // Check and make sure we could connect to the x server.
     if (helper_disp != NULL) {
         XGetPointerControl(helper_disp, &accel_numerator, &accel_denominator, &threshold);
@@ -331,6 +738,8 @@ UIOHOOK_API long int hook_get_pointer_acceleration_threshold() {
     long int value = -1;
     int accel_numerator, accel_denominator, threshold;
 
+    load_helper_display();
+
     // Check and make sure we could connect to the x server.
     if (helper_disp != NULL) {
         XGetPointerControl(helper_disp, &accel_numerator, &accel_denominator, &threshold);
@@ -352,6 +761,8 @@ UIOHOOK_API long int hook_get_pointer_sensitivity() {
     long int value = -1;
     int accel_numerator, accel_denominator, threshold;
 
+    load_helper_display();
+
     // Check and make sure we could connect to the x server.
     if (helper_disp != NULL) {
         XGetPointerControl(helper_disp, &accel_numerator, &accel_denominator, &threshold);
@@ -369,72 +780,19 @@ UIOHOOK_API long int hook_get_pointer_sensitivity() {
     return value;
 }
 
-UIOHOOK_API long int hook_get_multi_click_time() {
-    long int value = 200;
-    int click_time;
-    bool successful = false;
-
-    #ifdef USE_XT
-    // Check and make sure we could connect to the x server.
-    if (xt_disp != NULL) {
-        // Try and use the Xt extention to get the current multi-click.
-        if (!successful) {
-            // Fall back to the X Toolkit extension if available and other efforts failed.
-            click_time = XtGetMultiClickTime(xt_disp);
-            if (click_time >= 0) {
-                logger(LOG_LEVEL_DEBUG, "%s [%u]: XtGetMultiClickTime: %i.\n",
-                        __FUNCTION__, __LINE__, click_time);
-
-                successful = true;
-            }
-        }
-    } else {
-        logger(LOG_LEVEL_ERROR, "%s [%u]: %s\n",
-                __FUNCTION__, __LINE__, "XOpenDisplay failure!");
-    }
-    #endif
-
-    // Check and make sure we could connect to the x server.
-    if (helper_disp != NULL) {
-        // Try and acquire the multi-click time from the user defined X defaults.
-        if (!successful) {
-            char *xprop = XGetDefault(helper_disp, "*", "multiClickTime");
-            if (xprop != NULL && sscanf(xprop, "%4i", &click_time) != EOF) {
-                logger(LOG_LEVEL_DEBUG, "%s [%u]: X default 'multiClickTime' property: %i.\n",
-                        __FUNCTION__, __LINE__, click_time);
-
-                successful = true;
-            }
-        }
-
-        if (!successful) {
-            char *xprop = XGetDefault(helper_disp, "OpenWindows", "MultiClickTimeout");
-            if (xprop != NULL && sscanf(xprop, "%4i", &click_time) != EOF) {
-                logger(LOG_LEVEL_DEBUG, "%s [%u]: X default 'MultiClickTimeout' property: %i.\n",
-                        __FUNCTION__, __LINE__, click_time);
-
-                successful = true;
-            }
-        }
-    } else {
-        logger(LOG_LEVEL_WARN, "%s [%u]: XDisplay helper_disp is unavailable!\n",
-            __FUNCTION__, __LINE__);
-    }
+long int get_multi_click_time() {
+    return __atomic_load_n(&multi_click_time, __ATOMIC_RELAXED);
+}
 
-    if (successful) {
-        value = (long int) click_time;
-    }
+UIOHOOK_API long int hook_get_multi_click_time() {
+    // Refreshed by the settings thread while the hook runs.
+    load_multi_click_time();
 
-    return value;
+    return get_multi_click_time();
 }
 
-// Create a shared object constructor.
-__attribute__ ((constructor))
-void on_library_load() {
-    // Make sure we are initialized for threading.
-    XInitThreads();
-
-    // Open local display.
+// Open the helper display and take the snapshots that only need it.
+static void helper_display_init() {
     helper_disp = XOpenDisplay(XDisplayName(NULL));
     if (helper_disp == NULL) {
         logger(LOG_LEVEL_ERROR, "%s [%u]: %s\n",
@@ -442,9 +800,27 @@ void on_library_load() {
     } else {
         logger(LOG_LEVEL_DEBUG, "%s [%u]: %s\n",
                 __FUNCTION__, __LINE__, "XOpenDisplay success.");
+
+        // Take the initial monitor layout snapshot.
+        publish_screen_layout(create_screen_layout(helper_disp));
+
+        #ifndef USE_XTEST
+        previous_error_handler = XSetErrorHandler(&window_error_proc);
+
+        update_focus_window(helper_disp);
+        #endif
     }
+}
+
+void load_helper_display() {
+    pthread_once(&helper_display_once, helper_display_init);
+}
+
+// Start following setting changes.
+static void settings_thread_init() {
+    // Cache the multi-click time before the settings thread can refresh it.
+    load_multi_click_time();
 
-    #ifdef USE_XRANDR
     // Create the thread attribute.
     pthread_attr_t settings_thread_attr;
     pthread_attr_init(&settings_thread_attr);
@@ -460,16 +836,20 @@ void on_library_load() {
 
     // Make sure the thread attribute is removed.
     pthread_attr_destroy(&settings_thread_attr);
-    #endif
+}
 
-    #ifdef USE_XT
-    XtToolkitInitialize();
-    xt_context = XtCreateApplicationContext();
+void load_settings_thread() {
+    pthread_once(&settings_thread_once, settings_thread_init);
+}
 
-    int argc = 0;
-    char ** argv = { NULL };
-    xt_disp = XtOpenDisplay(xt_context, NULL, "UIOHook", "libuiohook", NULL, 0, &argc, argv);
-    #endif
+// Create a shared object constructor.
+__attribute__ ((constructor))
+void on_library_load() {
+    /* Make sure we are initialized for threading.  This must come before any
+     * other Xlib call in the process and does not contact the server, so it is
+     * the only thing not deferred until first use.
+     */
+    XInitThreads();
 }
 
 // Create a shared object destructor.
@@ -480,10 +860,18 @@ void on_library_unload() {
 
     // Cleanup.
     unload_input_helper();
+    release_screen_layout();
 
     #ifdef USE_XT
-    XtCloseDisplay(xt_disp);
-    XtDestroyApplicationContext(xt_context);
+    if (xt_disp != NULL) {
+        XtCloseDisplay(xt_disp);
+        xt_disp = NULL;
+    }
+
+    if (xt_context != NULL) {
+        XtDestroyApplicationContext(xt_context);
+        xt_context = NULL;
+    }
     #endif
 
     // Destroy the native displays.
@@ -491,4 +879,12 @@ void on_library_unload() {
         XCloseDisplay(helper_disp);
         helper_disp = NULL;
     }
+
+    #ifndef USE_XTEST
+    // Put back the previous error handler unless it was replaced after ours.
+    XErrorHandler handler = XSetErrorHandler(previous_error_handler);
+    if (handler != &window_error_proc) {
+        XSetErrorHandler(handler);
+    }
+    #endif
 }
@@ -0,0 +1,106 @@
+/* libUIOHook: Cross-platform keyboard and mouse hooking from userland.
+ * Copyright (C) 2006-2023 Alexander Barker.  All Rights Reserved.
+ * https://github.com/kwhat/libuiohook/
+ *
+ * libUIOHook is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libUIOHook is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <uiohook.h>
+
+#include "minunit.h"
+
+#if !defined(__APPLE__) && !defined(__MACH__) && !defined(_WIN32)
+#include <pthread.h>
+
+#include "dispatch_queue.h"
+
+#define TRANSFER_EVENTS 100000
+
+/* Capacity is rounded up and a full queue rejects non-blocking pushes */
+static char * test_capacity() {
+    dispatch_queue *queue = create_dispatch_queue(5);
+    mu_assert("error, could not create queue", queue != NULL);
+    mu_assert("error, capacity was not rounded up", dispatch_queue_capacity(queue) == 8);
+
+    uiohook_event event = { .type = EVENT_KEY_PRESSED };
+    for (unsigned int i = 0; i < 8; i++) {
+        event.time = i;
+        mu_assert("error, push failed before the queue was full", dispatch_queue_push(queue, &event, false));
+    }
+    mu_assert("error, push succeeded on a full queue", !dispatch_queue_push(queue, &event, false));
+
+    for (unsigned int i = 0; i < 8; i++) {
+        mu_assert("error, pop failed on a filled queue", dispatch_queue_pop(queue, &event, false));
+        mu_assert("error, events were not popped in order", event.time == i);
+    }
+    mu_assert("error, pop succeeded on an empty queue", !dispatch_queue_pop(queue, &event, false));
+
+    destroy_dispatch_queue(queue);
+
+    mu_assert("error, created a queue without capacity", create_dispatch_queue(0) == NULL);
+
+    return NULL;
+}
+
+static void *consumer_proc(void *arg) {
+    dispatch_queue *queue = (dispatch_queue *) arg;
+    uiohook_event event;
+    uint64_t expected = 0;
+
+    while (dispatch_queue_pop(queue, &event, true)) {
+        if (event.time != expected) {
+            break;
+        }
+        expected++;
+    }
+
+    return (void *) (uintptr_t) expected;
+}
+
+/* Events pushed by one thread arrive in order on another */
+static char * test_transfer() {
+    dispatch_queue *queue = create_dispatch_queue(64);
+    mu_assert("error, could not create queue", queue != NULL);
+
+    pthread_t consumer;
+    mu_assert("error, could not create consumer thread", pthread_create(&consumer, NULL, consumer_proc, queue) == 0);
+
+    uiohook_event event = { .type = EVENT_MOUSE_MOVED };
+    for (uint64_t i = 0; i < TRANSFER_EVENTS; i++) {
+        event.time = i;
+        dispatch_queue_push(queue, &event, true);
+    }
+    dispatch_queue_wake(queue);
+
+    void *received;
+    pthread_join(consumer, &received);
+    destroy_dispatch_queue(queue);
+
+    printf("Transferred %lu of %u events\n", (unsigned long) (uintptr_t) received, TRANSFER_EVENTS);
+    mu_assert("error, events were lost or reordered", (uintptr_t) received == TRANSFER_EVENTS);
+
+    return NULL;
+}
+#endif
+
+char * dispatch_queue_tests() {
+    #if !defined(__APPLE__) && !defined(__MACH__) && !defined(_WIN32)
+    mu_run_test(test_capacity);
+    mu_run_test(test_transfer);
+    #endif
+
+    return NULL;
+}
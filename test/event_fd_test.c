@@ -0,0 +1,141 @@
+/* libUIOHook: Cross-platform keyboard and mouse hooking from userland.
+ * Copyright (C) 2006-2023 Alexander Barker.  All Rights Reserved.
+ * https://github.com/kwhat/libuiohook/
+ *
+ * libUIOHook is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libUIOHook is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <uiohook.h>
+
+#include "minunit.h"
+
+#ifdef __linux__
+#include <poll.h>
+#include <X11/Xlib.h>
+#include <X11/Xproto.h>
+#include <X11/extensions/record.h>
+
+#include "input_helper.h"
+
+// A on a pc105 keyboard, evdev and xfree86 both use this.
+#define KEYCODE_A           38
+
+// Feed one key event through the hook the way the X server records it.
+static void record_key(unsigned int type, unsigned int keycode) {
+    xEvent xev;
+    memset(&xev, 0, sizeof(xev));
+    xev.u.u.type = type;
+    xev.u.u.detail = keycode;
+    xev.u.keyButtonPointer.sameScreen = xTrue;
+
+    XRecordInterceptData data;
+    memset(&data, 0, sizeof(data));
+    data.category = XRecordFromServer;
+    data.data_len = sizeof(xEvent) / 4;
+    data.data = (unsigned char *) &xev;
+
+    process_intercept_data(&data);
+}
+
+static bool is_readable(int fd) {
+    struct pollfd pfd = { fd, POLLIN, 0 };
+    return poll(&pfd, 1, 0) == 1 && (pfd.revents & POLLIN);
+}
+
+/* The descriptor is readable only while events are queued, and stays readable
+ * when a read leaves events behind.
+ */
+static char * test_readable_while_queued() {
+    uiohook_event events[8];
+
+    int fd = hook_open_event_fd(8, QUEUE_OVERFLOW_DROP);
+    mu_assert("error, could not open the event descriptor", fd >= 0);
+    mu_assert("error, opened a second event descriptor", hook_open_event_fd(8, QUEUE_OVERFLOW_DROP) < 0);
+    mu_assert("error, empty queue is readable", !is_readable(fd));
+    mu_assert("error, read events from an empty queue", hook_read_events(events, 8) == 0);
+
+    hook_set_event_mask(EVENT_TYPE_MASK(EVENT_KEY_PRESSED));
+    mu_assert("error, could not create synthetic hook", create_synthetic_hook() == UIOHOOK_SUCCESS);
+    mu_assert("error, descriptor closed while the hook is running", hook_close_event_fd() == UIOHOOK_FAILURE);
+
+    record_key(KeyPress, KEYCODE_A);
+    record_key(KeyRelease, KEYCODE_A);
+    record_key(KeyPress, KEYCODE_A);
+    record_key(KeyRelease, KEYCODE_A);
+    mu_assert("error, queued events are not readable", is_readable(fd));
+
+    // Enabled and two presses are queued, leave two of them behind.
+    mu_assert("error, did not read a partial batch", hook_read_events(events, 1) == 1);
+    mu_assert("error, hook enabled was not queued first", events[0].type == EVENT_HOOK_ENABLED);
+    mu_assert("error, descriptor was reset with events queued", is_readable(fd));
+
+    mu_assert("error, did not read the remaining events", hook_read_events(events, 8) == 2);
+    mu_assert("error, masked events were queued", events[0].type == EVENT_KEY_PRESSED && events[1].type == EVENT_KEY_PRESSED);
+    mu_assert("error, drained queue is readable", !is_readable(fd));
+
+    destroy_synthetic_hook();
+    hook_set_event_mask(EVENT_MASK_ALL);
+
+    mu_assert("error, hook disabled is not readable", is_readable(fd));
+    mu_assert("error, did not read hook disabled", hook_read_events(events, 8) == 1 && events[0].type == EVENT_HOOK_DISABLED);
+    mu_assert("error, drained queue is readable", !is_readable(fd));
+
+    mu_assert("error, could not close the event descriptor", hook_close_event_fd() == UIOHOOK_SUCCESS);
+    mu_assert("error, read events after close", hook_read_events(events, 8) == 0);
+
+    return NULL;
+}
+
+/* A full queue drops events and counts them when overflow is not blocking.
+ */
+static char * test_overflow_drop() {
+    uiohook_event events[8];
+
+    int fd = hook_open_event_fd(2, QUEUE_OVERFLOW_DROP);
+    mu_assert("error, could not open the event descriptor", fd >= 0);
+
+    hook_set_event_mask(EVENT_TYPE_MASK(EVENT_KEY_PRESSED));
+    mu_assert("error, could not create synthetic hook", create_synthetic_hook() == UIOHOOK_SUCCESS);
+
+    // Enabled and the first press fill the queue.
+    for (unsigned int i = 0; i < 3; i++) {
+        record_key(KeyPress, KEYCODE_A);
+        record_key(KeyRelease, KEYCODE_A);
+    }
+
+    dispatch_stats stats;
+    hook_get_dispatch_stats(&stats);
+    mu_assert("error, full queue did not drop events", stats.enqueued == 2 && stats.dropped == 2);
+    mu_assert("error, did not read the queued events", hook_read_events(events, 8) == 2);
+
+    destroy_synthetic_hook();
+    hook_set_event_mask(EVENT_MASK_ALL);
+
+    mu_assert("error, could not close the event descriptor", hook_close_event_fd() == UIOHOOK_SUCCESS);
+
+    return NULL;
+}
+#endif
+
+char * event_fd_tests() {
+    #ifdef __linux__
+    mu_run_test(test_readable_while_queued);
+    mu_run_test(test_overflow_drop);
+    #endif
+
+    return NULL;
+}
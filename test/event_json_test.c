@@ -0,0 +1,109 @@
+/* libUIOHook: Cross-platform keyboard and mouse hooking from userland.
+ * Copyright (C) 2006-2023 Alexander Barker.  All Rights Reserved.
+ * https://github.com/kwhat/libuiohook/
+ *
+ * libUIOHook is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libUIOHook is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <uiohook.h>
+
+#include "minunit.h"
+
+/* Event fields are written as valid JSON with quoted keys */
+static char * test_fields() {
+    char buffer[UIOHOOK_JSON_MAX_SIZE];
+
+    uiohook_event event = { .type = EVENT_MOUSE_PRESSED, .time = 1234567890123ULL, .mask = 0x101 };
+    event.data.mouse.button = MOUSE_BUTTON1;
+    event.data.mouse.clicks = 2;
+    event.data.mouse.x = -5;
+    event.data.mouse.y = 0;
+
+    const char *expected = "{\"id\":7,\"when\":1234567890123,\"mask\":257,\"x\":-5,\"y\":0,\"button\":1,\"clicks\":2,\"event\":\"MOUSE_PRESSED\"}";
+    size_t length = hook_event_to_json(&event, buffer, sizeof(buffer));
+    mu_assert("error, mouse event was not encoded", length == strlen(expected) && strcmp(buffer, expected) == 0);
+
+    event.type = EVENT_KEY_RELEASED;
+    event.time = UINT64_MAX;
+    event.mask = 0;
+    event.data.keyboard.keycode = VC_ENTER;
+    event.data.keyboard.rawcode = 0xFF0D;
+    expected = "{\"id\":5,\"when\":18446744073709551615,\"mask\":0,\"keycode\":28,\"rawcode\":65293,\"event\":\"KEY_RELEASED\"}";
+    length = hook_event_to_json(&event, buffer, sizeof(buffer));
+    mu_assert("error, key event was not encoded", length == strlen(expected) && strcmp(buffer, expected) == 0);
+
+    return NULL;
+}
+
+/* Key characters are escaped, encoded as UTF-8, or escaped as lone surrogates */
+static char * test_keychar() {
+    static const struct {
+        uint16_t keychar;
+        const char *json;
+    } cases[] = {
+        { 'a',    "\"keychar\":\"a\"" },
+        { '"',    "\"keychar\":\"\\\"\"" },
+        { '\\',   "\"keychar\":\"\\\\\"" },
+        { '\r',   "\"keychar\":\"\\r\"" },
+        { 0x01,   "\"keychar\":\"\\u0001\"" },
+        { 0x00E9, "\"keychar\":\"\xC3\xA9\"" },
+        { 0x20AC, "\"keychar\":\"\xE2\x82\xAC\"" },
+        { 0xD83D, "\"keychar\":\"\\ud83d\"" },
+        { 0xDE00, "\"keychar\":\"\\ude00\"" }
+    };
+
+    char buffer[UIOHOOK_JSON_MAX_SIZE];
+    uiohook_event event = { .type = EVENT_KEY_TYPED };
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        event.data.keyboard.keychar = cases[i].keychar;
+        mu_assert("error, typed event was not encoded", hook_event_to_json(&event, buffer, sizeof(buffer)) > 0);
+        mu_assert("error, keychar was not escaped", strstr(buffer, cases[i].json) != NULL);
+    }
+
+    return NULL;
+}
+
+/* The largest event fits UIOHOOK_JSON_MAX_SIZE and short buffers are rejected */
+static char * test_size() {
+    char buffer[UIOHOOK_JSON_MAX_SIZE];
+
+    uiohook_event event = { .type = EVENT_MOUSE_WHEEL, .time = UINT64_MAX, .mask = UINT16_MAX };
+    event.data.wheel.clicks = UINT16_MAX;
+    event.data.wheel.x = INT16_MIN;
+    event.data.wheel.y = INT16_MIN;
+    event.data.wheel.type = UINT8_MAX;
+    event.data.wheel.amount = UINT16_MAX;
+    event.data.wheel.rotation = INT16_MIN;
+    event.data.wheel.direction = UINT8_MAX;
+
+    size_t length = hook_event_to_json(&event, buffer, sizeof(buffer));
+    mu_assert("error, largest event did not fit", length > 0 && length < sizeof(buffer));
+
+    mu_assert("error, event was written without room for the terminator", hook_event_to_json(&event, buffer, length) == 0);
+    mu_assert("error, truncated output was not cleared", buffer[0] == '\0');
+    mu_assert("error, event did not fit an exact buffer", hook_event_to_json(&event, buffer, length + 1) == length);
+
+    return NULL;
+}
+
+char * event_json_tests() {
+    mu_run_test(test_fields);
+    mu_run_test(test_keychar);
+    mu_run_test(test_size);
+
+    return NULL;
+}
@@ -16,8 +16,14 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <stdbool.h>
 #include <stdint.h>
 #include <stdio.h>
+#include <X11/keysym.h>
+
+#if !defined(__APPLE__) && !defined(__MACH__) && !defined(_WIN32)
+#include <pthread.h>
+#endif
 
 #include "input_helper.h"
 #include "minunit.h"
@@ -101,9 +107,202 @@ static char * test_bidirectional_scancode() {
     return NULL;
 }
 
+#if !defined(__APPLE__) && !defined(__MACH__) && !defined(_WIN32)
+/* Make sure the keysym page table agrees with the sorted keysym table */
+static char * test_keysym_to_unicode() {
+    // Covers every table keysym and the unmapped keysyms around them.
+    for (KeySym keysym = 0; keysym <= 0xFFFF; keysym++) {
+        uint16_t expected = keysym_table_search(keysym);
+        if ((keysym >= 0x0020 && keysym <= 0x007E) || (keysym >= 0x00A0 && keysym <= 0x00FF)) {
+            // Latin-1 keysyms map 1:1 before any table is consulted.
+            expected = (uint16_t) keysym;
+        }
+
+        uint16_t unicode = 0x0000;
+        size_t count = keysym_to_unicode(keysym, &unicode, 1);
+        if (count != (expected != 0x0000 ? 1 : 0) || unicode != expected) {
+            printf("Keysym [0x%04lX] produced [0x%04X], expected [0x%04X]\n",
+                    (unsigned long) keysym, unicode, expected);
+        }
+        mu_assert("error, keysym page table does not match the keysym table",
+                count == (expected != 0x0000 ? 1 : 0) && unicode == expected);
+    }
+
+    return NULL;
+}
+
+/* Make sure the reverse page table leads back to the same characters */
+static char * test_unicode_to_keysym() {
+    static bool mapped[0x10000];
+
+    // Every character in the keysym table must lead back to a keysym producing it.
+    for (KeySym keysym = 0; keysym <= 0xFFFF; keysym++) {
+        uint16_t unicode = keysym_table_search(keysym);
+        if (unicode != 0x0000) {
+            mapped[unicode] = true;
+        }
+    }
+
+    for (uint32_t unicode = 0; unicode <= 0xFFFF; unicode++) {
+        KeySym keysym = unicode_to_keysym((uint16_t) unicode);
+
+        if ((unicode >= 0x0020 && unicode <= 0x007E) || (unicode >= 0x00A0 && unicode <= 0x00FF)) {
+            mu_assert("error, Latin-1 character is not mapped 1:1", keysym == unicode);
+        } else if (mapped[unicode]) {
+            if (keysym_table_search(keysym) != unicode) {
+                printf("Unicode [0x%04X] produced keysym [0x%04lX]\n", unicode, (unsigned long) keysym);
+            }
+            mu_assert("error, reverse table keysym does not produce the character",
+                    keysym_table_search(keysym) == unicode);
+        } else {
+            mu_assert("error, unmapped character is not a Unicode keysym",
+                    keysym == (unicode | 0x01000000));
+        }
+    }
+
+    return NULL;
+}
+
+#ifndef USE_XKB_COMMON
+static volatile bool translating;
+static volatile bool mistranslated;
+
+// Translate while the main thread keeps replacing the table.
+static void * translate_key_proc(void *arg) {
+    while (translating) {
+        KeySym keysym = translate_key(38, 0).keysym;
+        if (keysym != XK_a) {
+            mistranslated = true;
+        }
+    }
+
+    return NULL;
+}
+
+/* Make sure the key translation table picks the same group and level as XKB */
+static char * test_translate_key() {
+    // ONE_LEVEL and TWO_LEVEL, where Shift selects the second level.
+    XkbKTMapEntryRec shift_entry = { .active = True, .level = 1, .mods = { .mask = ShiftMask } };
+    XkbKeyTypeRec types[2] = {
+        { .mods = { .mask = 0 }, .num_levels = 1, .map_count = 0, .map = NULL },
+        { .mods = { .mask = ShiftMask }, .num_levels = 2, .map_count = 1, .map = &shift_entry }
+    };
+
+    // Keycode 38 has a latin and a cyrillic group, keycode 9 one group with one level.
+    KeySym syms[] = { XK_Escape, XK_a, XK_A, XK_Cyrillic_ef, XK_Cyrillic_EF };
+    XkbSymMapRec key_sym_map[256] = { { { 0 } } };
+    key_sym_map[9] = (XkbSymMapRec) { .kt_index = { 0 }, .group_info = XkbSetNumGroups(0, 1), .width = 1, .offset = 0 };
+    key_sym_map[38] = (XkbSymMapRec) { .kt_index = { 1, 1 }, .group_info = XkbSetNumGroups(0, 2), .width = 2, .offset = 1 };
+
+    XkbClientMapRec client_map = {
+        .num_types = 2, .types = types,
+        .key_sym_map = key_sym_map,
+        .num_syms = sizeof(syms) / sizeof(syms[0]), .syms = syms
+    };
+    XkbDescRec desc = { .min_key_code = 8, .max_key_code = 255, .map = &client_map };
+
+    load_key_translations(&desc);
+
+    mu_assert("error, unshifted key did not translate", translate_key(38, 0).keysym == XK_a);
+    mu_assert("error, unshifted key has the wrong character",
+            translate_key(38, 0).count == 1 && translate_key(38, 0).unicode[0] == 'a');
+    mu_assert("error, shifted key did not translate", translate_key(38, ShiftMask).keysym == XK_A);
+    mu_assert("error, unrelated modifier changed the level", translate_key(38, ShiftMask | Mod2Mask).keysym == XK_A);
+    mu_assert("error, second group did not translate", translate_key(38, 1 << 13).keysym == XK_Cyrillic_ef);
+    mu_assert("error, second group has the wrong character", translate_key(38, 1 << 13).unicode[0] == 0x0444);
+    mu_assert("error, third group did not wrap to the first", translate_key(38, 2 << 13).keysym == XK_a);
+    mu_assert("error, fourth group did not wrap to the second",
+            translate_key(38, (3 << 13) | ShiftMask).keysym == XK_Cyrillic_EF);
+    mu_assert("error, single group key did not wrap", translate_key(9, (1 << 13) | ShiftMask).keysym == XK_Escape);
+    mu_assert("error, unprintable key has a character", translate_key(9, 0).count == 0);
+    mu_assert("error, unmapped key has a keysym", translate_key(100, 0).keysym == NoSymbol);
+
+    // A reader must never see a freed table, however often it is replaced.
+    pthread_t reader;
+    translating = true;
+    mistranslated = false;
+    mu_assert("error, could not start the reader", pthread_create(&reader, NULL, translate_key_proc, NULL) == 0);
+    for (int i = 0; i < 1000; i++) {
+        load_key_translations(&desc);
+    }
+    translating = false;
+    pthread_join(reader, NULL);
+    mu_assert("error, key translated differently while the table was replaced", !mistranslated);
+
+    unload_input_helper();
+    mu_assert("error, translations outlived unload", translate_key(38, 0).keysym == NoSymbol);
+
+    return NULL;
+}
+#else
+// Keycode 38 has a latin and a cyrillic group, keycode 50 is Shift.
+static const char *test_keymap =
+    "xkb_keymap {\n"
+    "    xkb_keycodes { minimum = 8; maximum = 255; <AC01> = 38; <LFSH> = 50; };\n"
+    "    xkb_types {\n"
+    "        type \"ONE_LEVEL\" { modifiers = none; level_name[Level1] = \"Any\"; };\n"
+    "        type \"TWO_LEVEL\" { modifiers = Shift; map[Shift] = Level2;\n"
+    "            level_name[Level1] = \"Base\"; level_name[Level2] = \"Shift\"; };\n"
+    "    };\n"
+    "    xkb_compatibility {\n"
+    "        interpret Shift_L { action = SetMods(modifiers = Shift); };\n"
+    "    };\n"
+    "    xkb_symbols {\n"
+    "        key <AC01> { type = \"TWO_LEVEL\", [ a, A ], [ Cyrillic_ef, Cyrillic_EF ] };\n"
+    "        key <LFSH> { [ Shift_L ] };\n"
+    "        modifier_map Shift { <LFSH> };\n"
+    "    };\n"
+    "};\n";
+
+/* Make sure the state follows the recorded core state alone, whatever was
+ * recorded before it.
+ */
+static char * test_update_xkb_state() {
+    struct xkb_context *context = xkb_context_new(XKB_CONTEXT_NO_FLAGS);
+    mu_assert("error, could not create xkb context", context != NULL);
+
+    struct xkb_keymap *keymap = xkb_keymap_new_from_string(context, test_keymap,
+            XKB_KEYMAP_FORMAT_TEXT_V1, XKB_KEYMAP_COMPILE_NO_FLAGS);
+    struct xkb_state *state = keymap != NULL ? xkb_state_new(keymap) : NULL;
+    xkb_keymap_unref(keymap);
+    xkb_context_unref(context);
+    mu_assert("error, could not compile the test keymap", state != NULL);
+
+    update_xkb_state(state, ShiftMask);
+    bool shifted = xkb_state_key_get_one_sym(state, 38) == XK_A;
+
+    // Shift released, the second group locked by the desktop.
+    update_xkb_state(state, 1 << 13);
+    bool grouped = xkb_state_key_get_one_sym(state, 38) == XK_Cyrillic_ef;
+
+    // Nothing carries over from earlier events.
+    update_xkb_state(state, ShiftMask | (1 << 13));
+    update_xkb_state(state, 0);
+    bool released = xkb_state_key_get_one_sym(state, 38) == XK_a;
+
+    xkb_state_unref(state);
+
+    mu_assert("error, Shift did not select the second level", shifted);
+    mu_assert("error, recorded group was not applied", grouped);
+    mu_assert("error, state kept a modifier no longer recorded", released);
+
+    return NULL;
+}
+#endif
+#endif
+
 char * input_helper_tests() {
     mu_run_test(test_bidirectional_keycode);
     mu_run_test(test_bidirectional_scancode);
+    #if !defined(__APPLE__) && !defined(__MACH__) && !defined(_WIN32)
+    mu_run_test(test_keysym_to_unicode);
+    mu_run_test(test_unicode_to_keysym);
+    #ifndef USE_XKB_COMMON
+    mu_run_test(test_translate_key);
+    #else
+    mu_run_test(test_update_xkb_state);
+    #endif
+    #endif
 
     return NULL;
 }
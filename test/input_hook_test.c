@@ -0,0 +1,132 @@
+/* libUIOHook: Cross-platform keyboard and mouse hooking from userland.
+ * Copyright (C) 2006-2023 Alexander Barker.  All Rights Reserved.
+ * https://github.com/kwhat/libuiohook/
+ *
+ * libUIOHook is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libUIOHook is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <uiohook.h>
+
+#include "minunit.h"
+
+#if !defined(__APPLE__) && !defined(__MACH__) && !defined(_WIN32)
+#include <X11/Xlib.h>
+#include <X11/Xproto.h>
+#include <X11/extensions/record.h>
+
+#include "input_helper.h"
+
+// Caps Lock, Scroll Lock and A on a pc105 keyboard, evdev and xfree86 both use these.
+#define KEYCODE_CAPS_LOCK   66
+#define KEYCODE_SCROLL_LOCK 78
+#define KEYCODE_A           38
+
+// Modifier mask of the last key pressed event.
+static uint16_t pressed_mask = 0x0000;
+
+static void dispatch_proc(uiohook_event * const event) {
+    if (event->type == EVENT_KEY_PRESSED) {
+        pressed_mask = event->mask;
+    }
+}
+
+// Feed one key event through the hook the way the X server records it.
+static void record_key(unsigned int type, unsigned int keycode, unsigned int modifier_state) {
+    xEvent xev;
+    memset(&xev, 0, sizeof(xev));
+    xev.u.u.type = type;
+    xev.u.u.detail = keycode;
+    xev.u.keyButtonPointer.state = modifier_state;
+    xev.u.keyButtonPointer.sameScreen = xTrue;
+
+    XRecordInterceptData data;
+    memset(&data, 0, sizeof(data));
+    data.category = XRecordFromServer;
+    data.data_len = sizeof(xEvent) / 4;
+    data.data = (unsigned char *) &xev;
+
+    process_intercept_data(&data);
+}
+
+#if defined(USE_XKB_COMMON) || defined(USE_XKB_INDICATOR_EVENTS)
+/* The Caps Lock press and the key typed right after it already carry the new
+ * lock state and no key event asks the server for the indicators.
+ */
+static char * test_lock_state() {
+    hook_set_dispatch_proc(&dispatch_proc);
+    mu_assert("error, could not create synthetic hook", create_synthetic_hook() == UIOHOOK_SUCCESS);
+
+    unsigned long queries = get_indicator_state_queries();
+
+    // Lock, the server records the release and the next key with LockMask.
+    record_key(KeyPress, KEYCODE_CAPS_LOCK, 0);
+    uint16_t lock_press_mask = pressed_mask;
+    record_key(KeyRelease, KEYCODE_CAPS_LOCK, LockMask);
+    record_key(KeyPress, KEYCODE_A, LockMask);
+    uint16_t locked_mask = pressed_mask;
+    record_key(KeyRelease, KEYCODE_A, LockMask);
+
+    // Unlock, Caps Lock is released before the state changes.
+    record_key(KeyPress, KEYCODE_CAPS_LOCK, LockMask);
+    uint16_t unlock_press_mask = pressed_mask;
+    record_key(KeyRelease, KEYCODE_CAPS_LOCK, LockMask);
+    record_key(KeyPress, KEYCODE_A, 0);
+    uint16_t unlocked_mask = pressed_mask;
+    record_key(KeyRelease, KEYCODE_A, 0);
+
+    #ifdef USE_XKB_COMMON
+    // Scroll Lock has no modifier on common layouts, its press flips the lock.
+    uint16_t scroll_mask = pressed_mask & MASK_SCROLL_LOCK;
+    record_key(KeyPress, KEYCODE_SCROLL_LOCK, 0);
+    uint16_t scroll_press_mask = pressed_mask;
+    record_key(KeyRelease, KEYCODE_SCROLL_LOCK, 0);
+    record_key(KeyPress, KEYCODE_SCROLL_LOCK, 0);
+    uint16_t scroll_restore_mask = pressed_mask;
+    record_key(KeyRelease, KEYCODE_SCROLL_LOCK, 0);
+    #endif
+
+    unsigned long key_queries = get_indicator_state_queries() - queries;
+
+    destroy_synthetic_hook();
+    hook_set_dispatch_proc(NULL);
+
+    fprintf(stdout, "Indicator queries for key events: %lu\n", key_queries);
+    mu_assert("error, Caps Lock was not set on its own press", lock_press_mask & MASK_CAPS_LOCK);
+    mu_assert("error, Caps Lock was not set for the next key", locked_mask & MASK_CAPS_LOCK);
+    mu_assert("error, Caps Lock was not cleared on its own press", !(unlock_press_mask & MASK_CAPS_LOCK));
+    mu_assert("error, Caps Lock was not cleared for the next key", !(unlocked_mask & MASK_CAPS_LOCK));
+    mu_assert("error, key events queried the indicator state", key_queries == 0);
+    #ifdef USE_XKB_COMMON
+    mu_assert("error, Scroll Lock press did not toggle the lock", (scroll_press_mask & MASK_SCROLL_LOCK) != scroll_mask);
+    mu_assert("error, second Scroll Lock press did not toggle the lock back",
+            (scroll_restore_mask & MASK_SCROLL_LOCK) == scroll_mask);
+    #endif
+
+    return NULL;
+}
+#endif
+#endif
+
+char * input_hook_tests() {
+    #if !defined(__APPLE__) && !defined(__MACH__) && !defined(_WIN32)
+    #if defined(USE_XKB_COMMON) || defined(USE_XKB_INDICATOR_EVENTS)
+    mu_run_test(test_lock_state);
+    #endif
+    #endif
+
+    return NULL;
+}
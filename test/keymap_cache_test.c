@@ -0,0 +1,115 @@
+/* libUIOHook: Cross-platform keyboard and mouse hooking from userland.
+ * Copyright (C) 2006-2023 Alexander Barker.  All Rights Reserved.
+ * https://github.com/kwhat/libuiohook/
+ *
+ * libUIOHook is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libUIOHook is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "minunit.h"
+
+#if !defined(__APPLE__) && !defined(__MACH__) && !defined(_WIN32)
+#include <dirent.h>
+#include <limits.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "keymap_cache.h"
+
+// Remove the cache entries written under directory and the directory itself.
+static bool remove_cache_directory(const char *directory) {
+    char path[PATH_MAX];
+    snprintf(path, sizeof(path), "%s/libuiohook", directory);
+
+    DIR *dir = opendir(path);
+    if (dir != NULL) {
+        struct dirent *entry;
+        while ((entry = readdir(dir)) != NULL) {
+            if (strcmp(entry->d_name, ".") != 0 && strcmp(entry->d_name, "..") != 0) {
+                char file[PATH_MAX];
+                if (snprintf(file, sizeof(file), "%s/%s", path, entry->d_name) < (int) sizeof(file)) {
+                    unlink(file);
+                }
+            }
+        }
+        closedir(dir);
+        rmdir(path);
+    }
+
+    return rmdir(directory) == 0;
+}
+
+/* Entries are returned only for the hash they were written with */
+static char * test_keymap_cache() {
+    char directory[] = "/tmp/uiohook-keymap-XXXXXX";
+    mu_assert("error, could not create cache directory", mkdtemp(directory) != NULL);
+
+    char *previous = getenv("XDG_CACHE_HOME");
+    if (previous != NULL) {
+        previous = strdup(previous);
+    }
+    setenv("XDG_CACHE_HOME", directory, 1);
+
+    const char payload[] = "xkb_keymap { };";
+    uint64_t key = keymap_cache_hash(KEYMAP_CACHE_HASH_INIT, "evdev,pc105,us", 14);
+    uint64_t hash = keymap_cache_hash(KEYMAP_CACHE_HASH_INIT, payload, sizeof(payload));
+    mu_assert("error, hash ignored its input", key != hash && hash != KEYMAP_CACHE_HASH_INIT);
+    mu_assert("error, empty input changed the hash", keymap_cache_hash(hash, payload, 0) == hash);
+
+    size_t size = 0;
+    mu_assert("error, missing entry was read", keymap_cache_read(key, hash, &size) == NULL);
+    mu_assert("error, entry was not written", keymap_cache_write(key, hash, payload, sizeof(payload)));
+
+    void *data = keymap_cache_read(key, hash, &size);
+    mu_assert("error, entry was not read back", data != NULL);
+    bool same = size == sizeof(payload) && memcmp(data, payload, size) == 0;
+    free(data);
+    mu_assert("error, entry changed on disk", same);
+
+    mu_assert("error, entry was read for another hash", keymap_cache_read(key, hash + 1, &size) == NULL);
+    mu_assert("error, entry was read for another key", keymap_cache_read(key + 1, hash, &size) == NULL);
+
+    // A rewrite replaces the entry for the new hash.
+    mu_assert("error, entry was not replaced", keymap_cache_write(key, hash + 1, payload, 4));
+    data = keymap_cache_read(key, hash + 1, &size);
+    mu_assert("error, replaced entry was not read back", data != NULL && size == 4);
+    free(data);
+    mu_assert("error, replaced entry was read for the old hash", keymap_cache_read(key, hash, &size) == NULL);
+
+    bool removed = remove_cache_directory(directory);
+
+    if (previous != NULL) {
+        setenv("XDG_CACHE_HOME", previous, 1);
+        free(previous);
+    } else {
+        unsetenv("XDG_CACHE_HOME");
+    }
+
+    mu_assert("error, cache directory was not removed", removed);
+
+    return NULL;
+}
+#endif
+
+char * keymap_cache_tests() {
+    #if !defined(__APPLE__) && !defined(__MACH__) && !defined(_WIN32)
+    mu_run_test(test_keymap_cache);
+    #endif
+
+    return NULL;
+}
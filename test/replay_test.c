@@ -0,0 +1,199 @@
+/* libUIOHook: Cross-platform keyboard and mouse hooking from userland.
+ * Copyright (C) 2006-2023 Alexander Barker.  All Rights Reserved.
+ * https://github.com/kwhat/libuiohook/
+ *
+ * libUIOHook is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libUIOHook is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+#include <uiohook.h>
+
+#include "minunit.h"
+
+#if !defined(__APPLE__) && !defined(__MACH__) && !defined(_WIN32)
+#include "input_helper.h"
+
+#define NS_PER_MS 1000000
+#define SINK_EVENTS 8
+
+// When each event reached the sink, so the test never touches the display.
+static uint64_t sink_times[SINK_EVENTS];
+static size_t sink_count = 0;
+
+static uint64_t now_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t) ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static size_t sink_proc(const uiohook_event *events, size_t count, unsigned int flags) {
+    for (size_t i = 0; i < count && sink_count < SINK_EVENTS; i++) {
+        sink_times[sink_count++] = now_ns();
+    }
+
+    return count;
+}
+
+// A sink that takes 2 ms to post each batch.
+static size_t slow_sink_proc(const uiohook_event *events, size_t count, unsigned int flags) {
+    struct timespec delay = { 0, 2 * NS_PER_MS };
+    nanosleep(&delay, NULL);
+
+    return sink_proc(events, count, flags);
+}
+
+/* Invalid arguments are rejected and an empty stream posts nothing */
+static char * test_arguments() {
+    uiohook_event event = { .type = EVENT_MOUSE_MOVED };
+    replay_stats stats;
+
+    mu_assert("error, replay accepted a zero speed", hook_replay_events(&event, 1, 0, &stats) == UIOHOOK_FAILURE);
+    mu_assert("error, replay accepted a negative speed", hook_replay_events(&event, 1, -1, &stats) == UIOHOOK_FAILURE);
+
+    mu_assert("error, empty replay failed", hook_replay_events(&event, 0, 1, &stats) == UIOHOOK_SUCCESS);
+    mu_assert("error, empty replay posted events", stats.posted == 0);
+
+    return NULL;
+}
+
+/* Events are posted no earlier than their scaled recorded offsets */
+static char * test_timing() {
+    uiohook_event events[4];
+    for (unsigned int i = 0; i < 4; i++) {
+        events[i] = (uiohook_event) { .type = EVENT_MOUSE_MOVED, .time = 1000 + i * 10 };
+        events[i].data.mouse.x = 100 + i;
+        events[i].data.mouse.y = 100;
+    }
+
+    set_replay_sink(&sink_proc);
+    sink_count = 0;
+
+    // The replay starts after this, so every deadline is at least this late.
+    uint64_t begin = now_ns();
+    replay_stats stats;
+    int status = hook_replay_events(events, 4, 2.0, &stats);
+    set_replay_sink(NULL);
+
+    mu_assert("error, replay failed", status == UIOHOOK_SUCCESS);
+    mu_assert("error, not every event was posted", stats.posted == 4 && sink_count == 4);
+    for (unsigned int i = 1; i < 4; i++) {
+        mu_assert("error, event was posted before its deadline", sink_times[i] - begin >= i * 5 * NS_PER_MS);
+    }
+    mu_assert("error, replay finished before the last deadline", stats.duration_ns >= 15 * NS_PER_MS);
+    mu_assert("error, lateness statistics are inconsistent",
+            stats.late_mean_ns <= stats.late_max_ns && stats.late_p50_ns <= stats.late_p99_ns);
+
+    printf("Replay lateness: mean %lu ns, max %lu ns\n",
+            (unsigned long) stats.late_mean_ns, (unsigned long) stats.late_max_ns);
+
+    return NULL;
+}
+
+/* Timestamps that go backwards are posted at once, not measured from the start */
+static char * test_backwards() {
+    uint64_t times[4] = { 1000, 1020, 990, 1030 };
+    uiohook_event events[4];
+    for (unsigned int i = 0; i < 4; i++) {
+        events[i] = (uiohook_event) { .type = EVENT_MOUSE_MOVED, .time = times[i] };
+    }
+
+    set_replay_sink(&sink_proc);
+    sink_count = 0;
+
+    uint64_t begin = now_ns();
+    replay_stats stats;
+    int status = hook_replay_events(events, 4, 1.0, &stats);
+    set_replay_sink(NULL);
+
+    mu_assert("error, replay failed", status == UIOHOOK_SUCCESS);
+    mu_assert("error, not every event was posted", stats.posted == 4 && sink_count == 4);
+    mu_assert("error, backwards event was posted before the previous one", sink_times[2] >= sink_times[1]);
+    mu_assert("error, event after a backwards one was posted early", sink_times[3] - begin >= 30 * NS_PER_MS);
+    mu_assert("error, backwards event was measured from the start", stats.late_max_ns < 10 * NS_PER_MS);
+
+    return NULL;
+}
+
+// A sink that posts nothing.
+static size_t failing_sink_proc(const uiohook_event *events, size_t count, unsigned int flags) {
+    return 0;
+}
+
+/* Events that cannot be posted are skipped and failed posts are not counted as posted */
+static char * test_skipped() {
+    uiohook_event events[4] = {
+        { .type = EVENT_HOOK_ENABLED, .time = 1000 },
+        { .type = EVENT_KEY_PRESSED, .time = 1000 },
+        { .type = EVENT_KEY_TYPED, .time = 1000 },
+        { .type = EVENT_MOUSE_CLICKED, .time = 1010 }
+    };
+
+    set_replay_sink(&sink_proc);
+    sink_count = 0;
+
+    replay_stats stats;
+    int status = hook_replay_events(events, 4, 1.0, &stats);
+
+    mu_assert("error, replay failed", status == UIOHOOK_SUCCESS);
+    mu_assert("error, unpostable events reached the sink", sink_count == 1);
+    mu_assert("error, posted events were miscounted", stats.posted == 1 && stats.skipped == 3 && stats.failed == 0);
+    mu_assert("error, replay waited for a skipped event", stats.duration_ns < 10 * NS_PER_MS);
+
+    set_replay_sink(&failing_sink_proc);
+    status = hook_replay_events(events, 4, 1.0, &stats);
+    set_replay_sink(NULL);
+
+    mu_assert("error, replay failed", status == UIOHOOK_SUCCESS);
+    mu_assert("error, failed post was counted as posted", stats.posted == 0 && stats.failed == 1);
+    mu_assert("error, failed post was timed", stats.late_max_ns == 0);
+
+    return NULL;
+}
+
+/* Lateness includes the time spent posting each event */
+static char * test_post_time() {
+    uiohook_event events[4];
+    for (unsigned int i = 0; i < 4; i++) {
+        events[i] = (uiohook_event) { .type = EVENT_MOUSE_MOVED, .time = 1000 + i * 10 };
+    }
+
+    set_replay_sink(&slow_sink_proc);
+    sink_count = 0;
+
+    replay_stats stats;
+    int status = hook_replay_events(events, 4, 1.0, &stats);
+    set_replay_sink(NULL);
+
+    mu_assert("error, replay failed", status == UIOHOOK_SUCCESS);
+    mu_assert("error, not every event was posted", stats.posted == 4 && sink_count == 4);
+    mu_assert("error, lateness did not include the post", stats.late_mean_ns >= 2 * NS_PER_MS);
+
+    return NULL;
+}
+#endif
+
+char * replay_tests() {
+    #if !defined(__APPLE__) && !defined(__MACH__) && !defined(_WIN32)
+    mu_run_test(test_arguments);
+    mu_run_test(test_timing);
+    mu_run_test(test_backwards);
+    mu_run_test(test_post_time);
+    mu_run_test(test_skipped);
+    #endif
+
+    return NULL;
+}
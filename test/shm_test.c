@@ -0,0 +1,219 @@
+/* libUIOHook: Cross-platform keyboard and mouse hooking from userland.
+ * Copyright (C) 2006-2023 Alexander Barker.  All Rights Reserved.
+ * https://github.com/kwhat/libuiohook/
+ *
+ * libUIOHook is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libUIOHook is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <pthread.h>
+#include <sched.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <uiohook.h>
+#include <uiohook_shm.h>
+#include <unistd.h>
+
+#include "minunit.h"
+
+#define TRANSFER_EVENTS 100000
+
+static void ring_name(char *buffer, size_t size, const char *test) {
+    snprintf(buffer, size, "/uiohook-%s-%d", test, (int) getpid());
+}
+
+/* Records are read in place, in order, and a full ring drops new events */
+static char * test_ring() {
+    char name[64];
+    ring_name(name, sizeof(name), "ring");
+
+    uiohook_shm *writer = uiohook_shm_create(name, 3);
+    mu_assert("error, could not create ring", writer != NULL);
+
+    uiohook_shm *reader = uiohook_shm_open(name);
+    mu_assert("error, could not open ring", reader != NULL);
+    mu_assert("error, record size changed", sizeof(uiohook_shm_record) == 32);
+
+    const uiohook_shm_record *records;
+    mu_assert("error, new ring is not empty", uiohook_shm_peek(reader, &records) == 0);
+    mu_assert("error, wait on an empty ring did not time out", !uiohook_shm_wait(reader, 0));
+
+    uiohook_event event = { .type = EVENT_MOUSE_MOVED, .mask = MASK_SHIFT_L };
+    event.data.mouse.x = -10;
+    for (unsigned int i = 0; i < 4; i++) {
+        event.time = i;
+        mu_assert("error, write failed before the ring was full", uiohook_shm_write(writer, &event));
+    }
+    mu_assert("error, write succeeded on a full ring", !uiohook_shm_write(writer, &event));
+    mu_assert("error, dropped event was not counted", uiohook_shm_dropped(reader) == 1);
+
+    mu_assert("error, wait did not see queued records", uiohook_shm_wait(reader, 0));
+    mu_assert("error, peek did not return all records", uiohook_shm_peek(reader, &records) == 4);
+    mu_assert("error, record type was not packed", records[0].type == EVENT_MOUSE_MOVED);
+    mu_assert("error, record mask was not packed", records[0].mask == MASK_SHIFT_L);
+    mu_assert("error, record data was not packed", records[0].data.mouse.x == -10);
+    mu_assert("error, records were not in order", records[3].time == 3);
+    uiohook_shm_release(reader, 3);
+
+    // The next write wraps, so only one record is contiguous.
+    event.time = 4;
+    mu_assert("error, write failed after release", uiohook_shm_write(writer, &event));
+    mu_assert("error, peek crossed the end of the ring", uiohook_shm_peek(reader, &records) == 1);
+    mu_assert("error, records were not in order", records[0].time == 3);
+    uiohook_shm_release(reader, 1);
+    mu_assert("error, wrapped record was lost", uiohook_shm_peek(reader, &records) == 1 && records[0].time == 4);
+    uiohook_shm_release(reader, 1);
+
+    uiohook_shm_destroy(writer);
+    mu_assert("error, reader did not see close", uiohook_shm_closed(reader) && !uiohook_shm_wait(reader, -1));
+    uiohook_shm_close(reader);
+
+    mu_assert("error, ring name was not removed", uiohook_shm_open(name) == NULL);
+
+    return NULL;
+}
+
+static void *reader_proc(void *arg) {
+    uiohook_shm *reader = (uiohook_shm *) arg;
+    const uiohook_shm_record *records;
+    uint64_t expected = 0;
+
+    while (uiohook_shm_wait(reader, -1)) {
+        size_t count = uiohook_shm_peek(reader, &records);
+        for (size_t i = 0; i < count; i++) {
+            if (records[i].time != expected) {
+                return (void *) (uintptr_t) expected;
+            }
+            expected++;
+        }
+        uiohook_shm_release(reader, count);
+    }
+
+    return (void *) (uintptr_t) expected;
+}
+
+/* A sleeping reader is woken for every write until the writer closes */
+static char * test_doorbell() {
+    char name[64];
+    ring_name(name, sizeof(name), "doorbell");
+
+    uiohook_shm *writer = uiohook_shm_create(name, 64);
+    mu_assert("error, could not create ring", writer != NULL);
+
+    uiohook_shm *reader = uiohook_shm_open(name);
+    mu_assert("error, could not open ring", reader != NULL);
+
+    pthread_t consumer;
+    mu_assert("error, could not create reader thread", pthread_create(&consumer, NULL, reader_proc, reader) == 0);
+
+    uiohook_event event = { .type = EVENT_KEY_PRESSED };
+    for (uint64_t i = 0; i < TRANSFER_EVENTS; i++) {
+        event.time = i;
+        while (!uiohook_shm_write(writer, &event)) {
+            sched_yield();
+        }
+    }
+
+    // Wait for the reader to drain before closing.
+    const uiohook_shm_record *records;
+    while (uiohook_shm_peek(reader, &records) > 0) {
+        sched_yield();
+    }
+    uiohook_shm_destroy(writer);
+
+    void *received;
+    pthread_join(consumer, &received);
+    uiohook_shm_close(reader);
+
+    printf("Transferred %lu of %u events\n", (unsigned long) (uintptr_t) received, TRANSFER_EVENTS);
+    mu_assert("error, events were lost or reordered", (uintptr_t) received == TRANSFER_EVENTS);
+
+    return NULL;
+}
+
+static volatile sig_atomic_t interrupts = 0;
+
+static void interrupt_handler(int signum) {
+    interrupts++;
+}
+
+// Interrupt the waiting thread every 10 ms for at most one second.
+static void *interrupt_proc(void *arg) {
+    pthread_t waiter = *(pthread_t *) arg;
+    struct timespec delay = { 0, 10000000 };
+
+    for (unsigned int i = 0; i < 100 && interrupts >= 0; i++) {
+        pthread_kill(waiter, SIGUSR1);
+        nanosleep(&delay, NULL);
+    }
+
+    return NULL;
+}
+
+static uint64_t monotonic_ms() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t) now.tv_sec * 1000 + (uint64_t) now.tv_nsec / 1000000;
+}
+
+/* Signals do not extend a timed wait past its timeout */
+static char * test_wait_interrupted() {
+    char name[64];
+    ring_name(name, sizeof(name), "interrupted");
+
+    uiohook_shm *writer = uiohook_shm_create(name, 4);
+    mu_assert("error, could not create ring", writer != NULL);
+
+    uiohook_shm *reader = uiohook_shm_open(name);
+    mu_assert("error, could not open ring", reader != NULL);
+
+    // No SA_RESTART, so every signal ends the futex wait with EINTR.
+    struct sigaction action, previous;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = interrupt_handler;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGUSR1, &action, &previous);
+
+    interrupts = 0;
+    pthread_t waiter = pthread_self(), interrupter;
+    mu_assert("error, could not create interrupt thread", pthread_create(&interrupter, NULL, interrupt_proc, &waiter) == 0);
+
+    uint64_t start = monotonic_ms();
+    bool ready = uiohook_shm_wait(reader, 100);
+    uint64_t elapsed = monotonic_ms() - start;
+
+    sig_atomic_t count = interrupts;
+    interrupts = -1;
+    pthread_join(interrupter, NULL);
+    sigaction(SIGUSR1, &previous, NULL);
+
+    uiohook_shm_destroy(writer);
+    uiohook_shm_close(reader);
+
+    printf("Waited %lu ms through %d signals\n", (unsigned long) elapsed, (int) count);
+    mu_assert("error, wait on an empty ring did not time out", !ready);
+    mu_assert("error, signals extended the wait", elapsed < 500);
+
+    return NULL;
+}
+
+char * shm_tests() {
+    mu_run_test(test_ring);
+    mu_run_test(test_doorbell);
+    mu_run_test(test_wait_interrupted);
+
+    return NULL;
+}
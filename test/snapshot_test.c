@@ -0,0 +1,165 @@
+/* libUIOHook: Cross-platform keyboard and mouse hooking from userland.
+ * Copyright (C) 2006-2023 Alexander Barker.  All Rights Reserved.
+ * https://github.com/kwhat/libuiohook/
+ *
+ * libUIOHook is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libUIOHook is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "minunit.h"
+
+#if !defined(__APPLE__) && !defined(__MACH__) && !defined(_WIN32)
+#include <pthread.h>
+#include <time.h>
+
+#include "snapshot.h"
+
+#define SNAPSHOT_PUBLISHES  1000
+#define SNAPSHOT_READERS    3
+
+typedef struct _test_data {
+    uint64_t value;
+    uint64_t check;
+} test_data;
+
+static snapshot test_snapshot = SNAPSHOT_INITIALIZER;
+static volatile bool publishing = false;
+static volatile bool published = false;
+static volatile unsigned int readers_started = 0;
+
+static test_data * create_test_data(uint64_t value) {
+    test_data *data = malloc(sizeof(test_data));
+    if (data != NULL) {
+        data->value = value;
+        data->check = ~value;
+    }
+
+    return data;
+}
+
+static bool is_intact(const test_data *data) {
+    return __atomic_load_n(&data->check, __ATOMIC_RELAXED) == ~__atomic_load_n(&data->value, __ATOMIC_RELAXED);
+}
+
+static void *publisher_proc(void *arg) {
+    snapshot_publish(&test_snapshot, arg);
+    __atomic_store_n(&published, true, __ATOMIC_RELEASE);
+
+    return NULL;
+}
+
+/* A publish does not free the previous data while a reader holds it */
+static char * test_publish_waits() {
+    snapshot_publish(&test_snapshot, create_test_data(1));
+
+    unsigned int slot;
+    const test_data *data = snapshot_acquire(&test_snapshot, &slot);
+    mu_assert("error, published data was not current", data != NULL && data->value == 1);
+
+    pthread_t publisher;
+    mu_assert("error, could not create publisher thread",
+            pthread_create(&publisher, NULL, publisher_proc, create_test_data(2)) == 0);
+
+    struct timespec delay = { 0, 20000000 };
+    nanosleep(&delay, NULL);
+
+    mu_assert("error, publish returned while the old data was held", !__atomic_load_n(&published, __ATOMIC_ACQUIRE));
+    mu_assert("error, held data changed", is_intact(data) && data->value == 1);
+    snapshot_release(&test_snapshot, slot);
+
+    pthread_join(publisher, NULL);
+    mu_assert("error, publish did not return after the release", __atomic_load_n(&published, __ATOMIC_ACQUIRE));
+
+    data = snapshot_acquire(&test_snapshot, &slot);
+    mu_assert("error, new data was not current", data != NULL && data->value == 2);
+    snapshot_release(&test_snapshot, slot);
+
+    snapshot_publish(&test_snapshot, NULL);
+    data = snapshot_acquire(&test_snapshot, &slot);
+    snapshot_release(&test_snapshot, slot);
+    mu_assert("error, data outlived an empty publish", data == NULL);
+
+    return NULL;
+}
+
+static void *reader_proc(void *arg) {
+    uintptr_t torn = 0;
+
+    __atomic_add_fetch(&readers_started, 1, __ATOMIC_RELEASE);
+    while (__atomic_load_n(&publishing, __ATOMIC_ACQUIRE)) {
+        unsigned int slot;
+        const test_data *data = snapshot_acquire(&test_snapshot, &slot);
+        if (data != NULL) {
+            // Keep reading for a while, data freed under the reader would be reused.
+            for (unsigned int i = 0; i < 64; i++) {
+                if (!is_intact(data)) {
+                    torn++;
+                }
+            }
+        }
+        snapshot_release(&test_snapshot, slot);
+    }
+
+    return (void *) torn;
+}
+
+/* Readers never see data freed or reused while publishes keep coming */
+static char * test_publish_readers() {
+    __atomic_store_n(&publishing, true, __ATOMIC_RELEASE);
+
+    pthread_t readers[SNAPSHOT_READERS];
+    for (unsigned int i = 0; i < SNAPSHOT_READERS; i++) {
+        mu_assert("error, could not create reader thread", pthread_create(&readers[i], NULL, reader_proc, NULL) == 0);
+    }
+
+    while (__atomic_load_n(&readers_started, __ATOMIC_ACQUIRE) < SNAPSHOT_READERS) {
+        struct timespec delay = { 0, 100000 };
+        nanosleep(&delay, NULL);
+    }
+
+    for (uint64_t i = 0; i < SNAPSHOT_PUBLISHES; i++) {
+        test_data *data = create_test_data(i);
+        mu_assert("error, could not allocate data", data != NULL);
+
+        snapshot_publish(&test_snapshot, data);
+    }
+    __atomic_store_n(&publishing, false, __ATOMIC_RELEASE);
+
+    uintptr_t torn = 0;
+    for (unsigned int i = 0; i < SNAPSHOT_READERS; i++) {
+        void *result;
+        pthread_join(readers[i], &result);
+        torn += (uintptr_t) result;
+    }
+
+    snapshot_publish(&test_snapshot, NULL);
+
+    mu_assert("error, reader saw torn data", torn == 0);
+
+    return NULL;
+}
+#endif
+
+char * snapshot_tests() {
+    #if !defined(__APPLE__) && !defined(__MACH__) && !defined(_WIN32)
+    mu_run_test(test_publish_waits);
+    mu_run_test(test_publish_readers);
+    #endif
+
+    return NULL;
+}
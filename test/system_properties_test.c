@@ -16,10 +16,21 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <stdbool.h>
 #include <stdint.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <uiohook.h>
 
+#if !defined(__APPLE__) && !defined(__MACH__) && !defined(_WIN32)
+#include <limits.h>
+#include <string.h>
+#include <time.h>
+#include <X11/Xatom.h>
+#include <X11/Xlib.h>
+
+#include "input_helper.h"
+#endif
 #include "minunit.h"
 
 static char * test_auto_repeat_rate() {
@@ -76,6 +87,199 @@ static char * test_multi_click_time() {
     return NULL;
 }
 
+#if !defined(__APPLE__) && !defined(__MACH__) && !defined(_WIN32)
+static char * test_multi_click_time_cached() {
+    unsigned long lookups = get_multi_click_time_lookups();
+
+    // Simulate the per-event reads made by the hook, and the API calls.
+    for (int i = 0; i < 1000; i++) {
+        get_multi_click_time();
+        hook_get_multi_click_time();
+    }
+
+    fprintf(stdout, "Multi click time lookups: %lu\n", get_multi_click_time_lookups() - lookups);
+    mu_assert("error, multi click time was looked up per call", get_multi_click_time_lookups() == lookups);
+
+    return NULL;
+}
+
+// Wait up to two seconds for the settings thread to look the multi-click time up again.
+static bool wait_for_lookup(unsigned long lookups) {
+    for (int i = 0; i < 200 && get_multi_click_time_lookups() == lookups; i++) {
+        struct timespec delay = { 0, 10000000 };
+        nanosleep(&delay, NULL);
+    }
+
+    return get_multi_click_time_lookups() != lookups;
+}
+
+/* Changing the resource database refreshes the cached multi-click time */
+static char * test_multi_click_time_refresh() {
+    Display *disp = XOpenDisplay(XDisplayName(NULL));
+    mu_assert("error, could not open X display", disp != NULL);
+
+    Window root = XDefaultRootWindow(disp);
+    Atom resource_manager = XInternAtom(disp, "RESOURCE_MANAGER", False);
+
+    // Keep the current database so it can be put back.
+    Atom type;
+    int format;
+    unsigned long nitems, remaining;
+    unsigned char *original = NULL;
+    XGetWindowProperty(disp, root, resource_manager, 0, LONG_MAX / 4, False, XA_STRING,
+            &type, &format, &nitems, &remaining, &original);
+
+    size_t length = original != NULL ? strlen((char *) original) : 0;
+    char *resources = malloc(length + 64);
+    mu_assert("error, could not allocate resources", resources != NULL);
+    snprintf(resources, length + 64, "%sUIOHook.multiClickTime:\t%i\n",
+            original != NULL ? (char *) original : "", 431);
+
+    // Start the settings thread the way the hook does, it follows the database.
+    load_settings_thread();
+
+    unsigned long lookups = get_multi_click_time_lookups();
+    XChangeProperty(disp, root, resource_manager, XA_STRING, 8, PropModeReplace,
+            (unsigned char *) resources, (int) strlen(resources));
+    XSync(disp, False);
+    free(resources);
+
+    bool refreshed = wait_for_lookup(lookups);
+    long int refreshed_time = hook_get_multi_click_time();
+
+    // Put the original database back before checking anything.
+    lookups = get_multi_click_time_lookups();
+    if (original != NULL) {
+        XChangeProperty(disp, root, resource_manager, XA_STRING, 8, PropModeReplace, original, (int) length);
+        XFree(original);
+    } else {
+        XDeleteProperty(disp, root, resource_manager);
+    }
+    XSync(disp, False);
+    bool restored = wait_for_lookup(lookups);
+    XCloseDisplay(disp);
+
+    fprintf(stdout, "Refreshed multi click time: %li\n", refreshed_time);
+    mu_assert("error, multi click time was not refreshed", refreshed);
+    mu_assert("error, refreshed multi click time was not read from the database", refreshed_time == 431);
+    mu_assert("error, restored database was not read", restored);
+    mu_assert("error, multi click time kept the removed value", hook_get_multi_click_time() != 431);
+
+    return NULL;
+}
+
+#ifndef USE_XTEST
+// Wait up to two seconds for the settings thread to see the focus change to or from window.
+static bool wait_for_focus(Window window, bool focused) {
+    for (int i = 0; i < 200 && (get_focus_window() == window) != focused; i++) {
+        struct timespec delay = { 0, 10000000 };
+        nanosleep(&delay, NULL);
+    }
+
+    return (get_focus_window() == window) == focused;
+}
+
+/* Posting to a focus window that was just destroyed neither exits nor keeps it cached */
+static char * test_focus_window_destroyed() {
+    Display *disp = XOpenDisplay(XDisplayName(NULL));
+    mu_assert("error, could not open X display", disp != NULL);
+
+    // Make sure the settings thread is following the focus.
+    hook_get_multi_click_time();
+
+    // Override redirect keeps a window manager from moving the focus elsewhere.
+    XSetWindowAttributes attributes = { .override_redirect = True };
+    Window window = XCreateWindow(disp, XDefaultRootWindow(disp), 0, 0, 10, 10, 0, CopyFromParent,
+            InputOutput, CopyFromParent, CWOverrideRedirect, &attributes);
+    XMapWindow(disp, window);
+    XSync(disp, False);
+
+    XWindowAttributes state = { .map_state = IsUnmapped };
+    for (int i = 0; i < 200 && state.map_state != IsViewable; i++) {
+        struct timespec delay = { 0, 10000000 };
+        nanosleep(&delay, NULL);
+        XGetWindowAttributes(disp, window, &state);
+    }
+
+    XSetInputFocus(disp, window, RevertToPointerRoot, CurrentTime);
+    XSync(disp, False);
+    bool focused = wait_for_focus(window, true);
+
+    // The cached focus is now stale until the settings thread catches up.
+    XDestroyWindow(disp, window);
+    XSync(disp, False);
+
+    uiohook_event event = { .type = EVENT_KEY_PRESSED };
+    event.data.keyboard.keycode = VC_SHIFT_L;
+    hook_post_event(&event);
+    event.type = EVENT_KEY_RELEASED;
+    hook_post_event(&event);
+
+    bool forgotten = wait_for_focus(window, false);
+    XCloseDisplay(disp);
+
+    mu_assert("error, focus change to a client window was not seen", focused);
+    mu_assert("error, destroyed focus window is still cached", forgotten);
+
+    return NULL;
+}
+#else
+/* A spare keycode bound by hook_post_text() is unbound again before it returns,
+ * so the keyboard mapping is left as it was found.
+ */
+static char * test_post_text_restores_binding() {
+    // U+263A WHITE SMILING FACE is not on any common layout.
+    const KeySym keysym = 0x0100263A;
+    size_t posted = hook_post_text("\xE2\x98\xBA");
+    if (posted == 0) {
+        fprintf(stdout, "No spare keycode to bind, skipping.\n");
+        return NULL;
+    }
+
+    Display *disp = XOpenDisplay(XDisplayName(NULL));
+    mu_assert("error, could not open X display", disp != NULL);
+
+    int min_keycode, max_keycode, keysyms_per_keycode;
+    XDisplayKeycodes(disp, &min_keycode, &max_keycode);
+    KeySym *keysyms = XGetKeyboardMapping(disp, (KeyCode) min_keycode, max_keycode - min_keycode + 1,
+            &keysyms_per_keycode);
+
+    bool bound = false;
+    for (int i = 0; keysyms != NULL && i <= max_keycode - min_keycode && !bound; i++) {
+        bound = keysyms[i * keysyms_per_keycode] == keysym;
+    }
+
+    if (keysyms != NULL) {
+        XFree(keysyms);
+    }
+    XCloseDisplay(disp);
+
+    mu_assert("error, spare keycode is still bound after hook_post_text() returned", !bound);
+
+    return NULL;
+}
+#endif
+#endif
+
+static char * test_screen_info() {
+    unsigned char count = 0;
+    screen_data *screens = hook_create_screen_info(&count);
+
+    fprintf(stdout, "Screen count: %u\n", count);
+    mu_assert("error, could not determine screen info", screens != NULL && count > 0);
+
+    // A second call must produce an identical copy of the layout.
+    unsigned char copy_count = 0;
+    screen_data *copy = hook_create_screen_info(&copy_count);
+    mu_assert("error, screen info copies differ", copy != NULL && copy_count == count
+            && copy[0].width == screens[0].width && copy[0].height == screens[0].height);
+
+    free(screens);
+    free(copy);
+
+    return NULL;
+}
+
 char * system_properties_tests() {
     mu_run_test(test_auto_repeat_rate);
     mu_run_test(test_auto_repeat_delay);
@@ -85,6 +289,17 @@ char * system_properties_tests() {
     mu_run_test(test_pointer_sensitivity);
 
     mu_run_test(test_multi_click_time);
+    #if !defined(__APPLE__) && !defined(__MACH__) && !defined(_WIN32)
+    mu_run_test(test_multi_click_time_cached);
+    mu_run_test(test_multi_click_time_refresh);
+    #ifndef USE_XTEST
+    mu_run_test(test_focus_window_destroyed);
+    #else
+    mu_run_test(test_post_text_restores_binding);
+    #endif
+    #endif
+
+    mu_run_test(test_screen_info);
 
     return NULL;
 }
@@ -25,8 +25,19 @@
 #include "input_helper.h"
 #include "minunit.h"
 
+extern char * dispatch_queue_tests();
+extern char * event_fd_tests();
+extern char * event_json_tests();
 extern char * system_properties_tests();
 extern char * input_helper_tests();
+extern char * input_hook_tests();
+extern char * keymap_cache_tests();
+extern char * replay_tests();
+extern char * snapshot_tests();
+
+#ifdef USE_SHM
+extern char * shm_tests();
+#endif
 
 #if !defined(__APPLE__) && !defined(__MACH__) && !defined(_WIN32)
 static Display *disp;
@@ -66,6 +77,16 @@ static char * all_tests() {
 
     mu_run_test(system_properties_tests);
     mu_run_test(input_helper_tests);
+    mu_run_test(input_hook_tests);
+    mu_run_test(keymap_cache_tests);
+    mu_run_test(dispatch_queue_tests);
+    mu_run_test(event_fd_tests);
+    mu_run_test(event_json_tests);
+    mu_run_test(replay_tests);
+    mu_run_test(snapshot_tests);
+    #ifdef USE_SHM
+    mu_run_test(shm_tests);
+    #endif
 
     mu_run_test(cleanup_tests);
 